@@ -0,0 +1,269 @@
+/*
+ * Benchmark.cpp
+ *
+ * Mede todas as funcoes de TP1 (e as suas variantes) para tamanhos de entrada
+ * crescentes e escreve os resultados em CSV no stdout, uma linha por caso:
+ *
+ *   function,variant,n,calls,time_us,allocs,alloc_bytes,peak_bytes
+ *
+ * time_us, allocs e alloc_bytes sao medias por chamada; peak_bytes e o maximo de
+ * memoria alocada pelo caso (acima da que ja estava alocada antes de comecar).
+ * Cada caso e chamado uma vez antes de medir: as versoes memoized medem consultas
+ * a uma memoria ja preenchida. factorialRecurs, factorialDinam, s_recursive e b_recursive
+ * consultam as tabelas de Tables.h ate ao seu limite e, acima dele, usam os calculos com
+ * BigInt: as variantes sao "<nome>_table" e "<nome>_bigint", conforme o caminho medido.
+ *
+ * Compilacao (junto com as fontes de TP1, excepto Test.cpp que tem o seu main):
+ *   g++ -std=c++14 -O2 -pthread -o benchmark bench/Benchmark.cpp \
+ *       src/BigInt.cpp src/Change.cpp src/Factorial.cpp src/Partitioning.cpp src/Sum.cpp
+ *
+ * Opcoes: --quick (tamanhos pequenos), --filter <texto> (so as funcoes cujo nome o contem),
+ *         --min-time <ms> (tempo minimo medido por caso, 100 por omissao).
+ */
+
+#include "../src/Defs.h"
+#include "../src/Factorial.h"
+#include "../src/Change.h"
+#include "../src/Sum.h"
+#include "../src/Partitioning.h"
+#include "../src/Tables.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+/* Contagem de alocacoes: o operator new global guarda o tamanho antes do bloco. */
+static atomic<long long> allocCount(0), allocBytes(0), liveBytes(0), peakBytes(0);
+static const size_t HEADER = 16;   // mantem o alinhamento de malloc
+
+void* operator new(size_t size)
+{
+	char *block = (char*) malloc(size + HEADER);
+	if (block == NULL)
+		throw bad_alloc();
+	*(size_t*) block = size;
+	allocCount.fetch_add(1, memory_order_relaxed);
+	allocBytes.fetch_add(size, memory_order_relaxed);
+	long long live = liveBytes.fetch_add(size, memory_order_relaxed) + size;
+	long long peak = peakBytes.load(memory_order_relaxed);
+	while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+		;
+	return block + HEADER;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (ptr == NULL)
+		return;
+	char *block = (char*) ptr - HEADER;
+	liveBytes.fetch_sub(*(size_t*) block, memory_order_relaxed);
+	free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+/* Impede o compilador de eliminar chamadas cujo resultado nao e usado. */
+static volatile long long sink;
+
+template <class T>
+static void consume(const T &value) { sink += sizeof(value); }
+static void consume(int value) { sink += value; }
+static void consume(unsigned value) { sink += value; }
+static void consume(const string &value) { sink += value.size(); }
+
+struct BenchCase {
+	string name;
+	string variant;
+	long long n;
+	function<void()> run;
+};
+
+static void measure(const BenchCase &c, double minTimeMs)
+{
+	typedef chrono::steady_clock Clock;
+	c.run();   // aquecimento (e tabelas estaticas ja preenchidas)
+
+	long long allocs0 = allocCount.load(), bytes0 = allocBytes.load();
+	long long live0 = liveBytes.load();
+	peakBytes.store(live0);
+
+	// lotes de tamanho crescente, para o relogio nao pesar nas funcoes rapidas
+	long long calls = 0, batch = 1;
+	Clock::time_point start = Clock::now();
+	double elapsedUs = 0;
+	do {
+		for (long long i = 0; i < batch; i++)
+			c.run();
+		calls += batch;
+		batch = min(batch * 2, 1LL << 16);
+		elapsedUs = chrono::duration<double, micro>(Clock::now() - start).count();
+	} while (elapsedUs < minTimeMs * 1000);
+
+	printf("%s,%s,%lld,%lld,%.3f,%.1f,%.1f,%lld\n", c.name.c_str(), c.variant.c_str(), c.n, calls,
+			elapsedUs / calls, double(allocCount.load() - allocs0) / calls,
+			double(allocBytes.load() - bytes0) / calls, peakBytes.load() - live0);
+	fflush(stdout);
+}
+
+static vector<int> randomSequence(int size, unsigned seed)
+{
+	srand(seed);
+	vector<int> seq(size);
+	for (int &x : seq)
+		x = rand() % 2001 - 1000;
+	return seq;
+}
+
+/* Ficheiros temporarios criados para calcSumFile (apagados no fim de main). */
+static vector<string> tempFiles;
+
+static string writeSequenceFile(const vector<int> &seq)
+{
+	char path[] = "/tmp/benchmarkXXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		perror("mkstemp");
+		exit(1);
+	}
+	size_t bytes = seq.size() * sizeof(int);
+	if (write(fd, seq.data(), bytes) != (ssize_t) bytes) {
+		perror("write");
+		exit(1);
+	}
+	close(fd);
+	tempFiles.push_back(path);
+	return path;
+}
+
+/* Repoe no stock as moedas de uma resposta de dispense ("valor;valor;..."). */
+static void restock(BoundedChangeMaker &maker, const string &coins)
+{
+	if (coins == "-")
+		return;
+	istringstream in(coins);
+	string value;
+	while (getline(in, value, ';'))
+		maker.addStock(atoi(value.c_str()), 1);
+}
+
+/* Variante de uma funcao servida pelas tabelas de Tables.h ate tableMax e por BigInt acima. */
+static string tableOrBig(const string &variant, long long n, int tableMax)
+{
+	return variant + (n <= tableMax ? "_table" : "_bigint");
+}
+
+static vector<BenchCase> buildCases(bool quick)
+{
+	vector<BenchCase> cases;
+	auto add = [&cases](const string &name, const string &variant, long long n, function<void()> run) {
+		cases.push_back(BenchCase{name, variant, n, run});
+	};
+
+	for (int n : {5, 10, 20, 30, 100}) {
+		add("factorial", tableOrBig("recursive", n, FACTORIAL_TABLE_MAX), n, [n] { consume(factorialRecurs(n)); });
+		add("factorial", tableOrBig("dynamic", n, FACTORIAL_TABLE_MAX), n, [n] { consume(factorialDinam(n)); });
+	}
+	for (int n : quick ? vector<int>{100, 1000, 10000} : vector<int>{100, 1000, 10000, 100000, 1000000}) {
+		add("factorial", "big_1thread", n, [n] { consume(factorialBig(n, 1)); });
+		add("factorial", "big_parallel", n, [n] { consume(factorialBig(n)); });
+	}
+
+	for (int size : quick ? vector<int>{10, 100, 1000} : vector<int>{10, 100, 1000, 10000, 30000}) {
+		auto seq = make_shared<vector<int> >(randomSequence(size, size));
+		add("calcSum", "string", size, [seq] { consume(calcSum(seq->data(), seq->size())); });
+		add("calcSum", "pairs", size, [seq] { consume(calcSumPairs(seq->data(), seq->size())); });
+		add("calcSum", "incremental", size, [seq] {
+			MinWindowSums sums;
+			for (int x : *seq)
+				sums.append(x);
+			consume(sums.result());
+		});
+		// todos os comprimentos 1..size, como calcSumPairs
+		string path = writeSequenceFile(*seq);
+		auto lengths = make_shared<vector<long long> >();
+		for (long long m = 1; m <= size; m++)
+			lengths->push_back(m);
+		add("calcSum", "file", size, [path, lengths] { consume(calcSumFile(path, *lengths)); });
+	}
+
+	// sistema canonico (euro) e nao canonico (maior moeda 97)
+	static int euro[] = {1, 2, 5, 10, 20, 50, 100, 200};
+	static int odd[] = {1, 13, 31, 53, 97};
+	static int stock[] = {1000000, 1000000, 1000000, 1000000, 1000000, 1000000, 1000000, 1000000};
+	auto euroMaker = make_shared<ChangeMaker>(8, euro);
+	auto oddMaker = make_shared<ChangeMaker>(5, odd);
+	for (unsigned long long m : {100ULL, 1000000ULL, 1000000000000ULL, 1000000000000000000ULL}) {
+		add("changeCompressed", "canonical", m, [euroMaker, m] { consume(euroMaker->changeCompressed(m)); });
+		add("changeCompressed", "table", m, [oddMaker, m] { consume(oddMaker->changeCompressed(m)); });
+		add("changeCounts", "table", m, [oddMaker, m] {
+			vector<pair<int,unsigned long long> > counts;
+			consume(oddMaker->changeCounts(m, counts) ? (int) counts.size() : 0);
+		});
+	}
+
+	for (int m : quick ? vector<int>{100, 10000} : vector<int>{100, 10000, 1000000, 10000000}) {
+		add("calcChange", "maker_canonical", m, [m] { consume(calcChange(m, 8, euro)); });
+		add("calcChange", "maker_table", m, [m] { consume(calcChange(m, 5, odd)); });
+		add("calcChange", "wavefront", m, [m] { consume(calcChangeParallel(m, 5, odd)); });
+		add("countChange", "single", m, [m] { consume(countChange(m, 5, odd, 1000000007)); });
+		if (m <= 1000000) {
+			add("calcChangeBounded", "monotone_queue", m, [m] { consume(calcChangeBounded(m, 5, odd, stock)); });
+			// cada chamada entrega o troco e repoe as moedas: mede o recalculo das camadas
+			// invalidadas pela mudanca de stock, como numa maquina de trocos
+			auto machine = make_shared<BoundedChangeMaker>(5, odd, stock);
+			add("dispense", "restock", m, [machine, m] { restock(*machine, machine->dispense(m)); });
+		}
+	}
+
+	for (int n : quick ? vector<int>{10, 25, 50} : vector<int>{10, 25, 50, 100, 200, 400}) {
+		int k = n / 2;
+		add("s", tableOrBig("recursive", n, PARTITION_TABLE_MAX), n, [n, k] { consume(s_recursive(n, k)); });
+		add("s", "dynamic_int", n, [n, k] { consume(s_dynamic(n, k)); });
+		add("s", "dynamic_row_big", n, [n] { consume(s_dynamic(n)); });
+		add("s", "wavefront_mod", n, [n] { consume(s_dynamicMod(n, 1000000007)); });
+		add("s", "memoized", n, [n, k] { consume(s_memoized(n, k)); });
+		add("b", tableOrBig("recursive", n, PARTITION_TABLE_MAX), n, [n] { consume(b_recursive(n)); });
+		add("b", "dynamic", n, [n] { consume(b_dynamic(n)); });
+		add("b", "memoized", n, [n] { consume(b_memoized(n)); });
+		add("b", "bell_mod", n, [n] { consume(bellNumbersMod(n, 1000000007)); });
+	}
+	return cases;
+}
+
+int main(int argc, char const *argv[])
+{
+	bool quick = false;
+	string filter;
+	double minTimeMs = 100;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0)
+			quick = true;
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+			minTimeMs = atof(argv[++i]);
+		else {
+			cerr << "uso: " << argv[0] << " [--quick] [--filter <funcao>] [--min-time <ms>]" << endl;
+			return 1;
+		}
+	}
+
+	printf("function,variant,n,calls,time_us,allocs,alloc_bytes,peak_bytes\n");
+	for (const BenchCase &c : buildCases(quick))
+		if (filter.empty() || c.name.find(filter) != string::npos)
+			measure(c, minTimeMs);
+	for (const string &path : tempFiles)
+		remove(path.c_str());
+	return 0;
+}
@@ -0,0 +1,355 @@
+/*
+ * BigInt.cpp
+ */
+
+#include "BigInt.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <ostream>
+
+typedef vector<uint32_t> Limbs;
+
+// abaixo deste numero de limbs a multiplicacao escolar e mais rapida que Karatsuba
+static const size_t KARATSUBA_THRESHOLD = 40;
+// operandos menores do que isto nao sao divididos por varias threads
+static const size_t PARALLEL_MUL_THRESHOLD = 16 * KARATSUBA_THRESHOLD;
+
+BigInt::BigInt(unsigned long long value)
+{
+	while (value != 0) {
+		limbs.push_back((uint32_t) value);
+		value >>= 32;
+	}
+}
+
+void BigInt::trim()
+{
+	while (!limbs.empty() && limbs.back() == 0)
+		limbs.pop_back();
+}
+
+BigInt& BigInt::operator+=(const BigInt &other)
+{
+	if (limbs.size() < other.limbs.size())
+		limbs.resize(other.limbs.size(), 0);
+	uint64_t carry = 0;
+	size_t i = 0;
+	for (; i < other.limbs.size(); i++) {
+		carry += (uint64_t) limbs[i] + other.limbs[i];
+		limbs[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	for (; carry != 0 && i < limbs.size(); i++) {
+		carry += limbs[i];
+		limbs[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	if (carry != 0)
+		limbs.push_back((uint32_t) carry);
+	return *this;
+}
+
+BigInt BigInt::operator+(const BigInt &other) const
+{
+	BigInt res(*this);
+	res += other;
+	return res;
+}
+
+void BigInt::setSum(const BigInt &a, const BigInt &b)
+{
+	const vector<uint32_t> &big = a.limbs.size() >= b.limbs.size() ? a.limbs : b.limbs;
+	const vector<uint32_t> &small = a.limbs.size() >= b.limbs.size() ? b.limbs : a.limbs;
+	size_t n = big.size(), k = small.size();
+	limbs.resize(n + 1);
+	const uint32_t *pb = big.data(), *ps = small.data();
+	uint32_t *out = limbs.data();
+	uint64_t carry = 0;
+	size_t i = 0;
+	for (; i < k; i++) {
+		carry += (uint64_t) pb[i] + ps[i];
+		out[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	for (; i < n; i++) {
+		carry += pb[i];
+		out[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	out[n] = (uint32_t) carry;
+	trim();
+}
+
+BigInt& BigInt::operator*=(uint32_t factor)
+{
+	if (factor == 0) {
+		limbs.clear();
+		return *this;
+	}
+	uint64_t carry = 0;
+	for (uint32_t &limb : limbs) {
+		carry += (uint64_t) limb * factor;
+		limb = (uint32_t) carry;
+		carry >>= 32;
+	}
+	if (carry != 0)
+		limbs.push_back((uint32_t) carry);
+	return *this;
+}
+
+BigInt BigInt::operator*(uint32_t factor) const
+{
+	BigInt res(*this);
+	res *= factor;
+	return res;
+}
+
+static void trimLimbs(Limbs &x)
+{
+	while (!x.empty() && x.back() == 0)
+		x.pop_back();
+}
+
+static Limbs mulSchool(const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+	Limbs res(na + nb, 0);
+	for (size_t i = 0; i < na; i++) {
+		uint64_t carry = 0;
+		for (size_t j = 0; j < nb; j++) {
+			carry += (uint64_t) a[i] * b[j] + res[i + j];
+			res[i + j] = (uint32_t) carry;
+			carry >>= 32;
+		}
+		res[i + nb] = (uint32_t) carry;
+	}
+	trimLimbs(res);
+	return res;
+}
+
+static Limbs addLimbs(const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+	if (na < nb) {
+		swap(a, b);
+		swap(na, nb);
+	}
+	Limbs res(na + 1);
+	uint64_t carry = 0;
+	for (size_t i = 0; i < na; i++) {
+		carry += (uint64_t) a[i] + (i < nb ? b[i] : 0);
+		res[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	res[na] = (uint32_t) carry;
+	trimLimbs(res);
+	return res;
+}
+
+/* x -= y, com x >= y */
+static void subInPlace(Limbs &x, const Limbs &y)
+{
+	int64_t borrow = 0;
+	for (size_t i = 0; i < x.size() && (i < y.size() || borrow != 0); i++) {
+		int64_t cur = (int64_t) x[i] - (i < y.size() ? y[i] : 0) - borrow;
+		borrow = cur < 0;
+		x[i] = (uint32_t) (cur + (borrow << 32));
+	}
+	trimLimbs(x);
+}
+
+/* x += y * 2^(32*shift); x tem espaco para o resultado */
+static void addShifted(Limbs &x, const Limbs &y, size_t shift)
+{
+	uint64_t carry = 0;
+	size_t i = 0;
+	for (; i < y.size(); i++) {
+		carry += (uint64_t) x[i + shift] + y[i];
+		x[i + shift] = (uint32_t) carry;
+		carry >>= 32;
+	}
+	for (i += shift; carry != 0; i++) {
+		carry += x[i];
+		x[i] = (uint32_t) carry;
+		carry >>= 32;
+	}
+}
+
+/* Produto de duas sequencias de limbs: a = a1*B^m + a0, b = b1*B^m + b0,
+ * a*b = z2*B^2m + ((a0+a1)(b0+b1) - z0 - z2)*B^m + z0 */
+static Limbs mulLimbs(const uint32_t *a, size_t na, const uint32_t *b, size_t nb)
+{
+	if (na < nb) {
+		swap(a, b);
+		swap(na, nb);
+	}
+	if (nb < KARATSUBA_THRESHOLD)
+		return mulSchool(a, na, b, nb);
+
+	Limbs res(na + nb, 0);
+	if (2 * nb <= na) {
+		// operandos desequilibrados: a em fatias do tamanho de b
+		for (size_t i = 0; i < na; i += nb)
+			addShifted(res, mulLimbs(a + i, min(nb, na - i), b, nb), i);
+		trimLimbs(res);
+		return res;
+	}
+
+	size_t m = na / 2;
+	Limbs z0 = mulLimbs(a, m, b, m);
+	Limbs z2 = mulLimbs(a + m, na - m, b + m, nb - m);
+	Limbs sa = addLimbs(a, m, a + m, na - m);
+	Limbs sb = addLimbs(b, m, b + m, nb - m);
+	Limbs z1 = mulLimbs(sa.data(), sa.size(), sb.data(), sb.size());
+	subInPlace(z1, z0);
+	subInPlace(z1, z2);
+
+	addShifted(res, z0, 0);
+	addShifted(res, z1, m);
+	addShifted(res, z2, 2 * m);
+	trimLimbs(res);
+	return res;
+}
+
+BigInt BigInt::operator*(const BigInt &other) const
+{
+	BigInt res;
+	if (isZero() || other.isZero())
+		return res;
+	res.limbs = mulLimbs(limbs.data(), limbs.size(), other.limbs.data(), other.limbs.size());
+	return res;
+}
+
+/* No de uma multiplicacao paralela: ou uma tarefa do pool (folha), ou um passo de
+ * Karatsuba com tres sub-produtos. Os operandos ficam guardados no proprio no. */
+struct ParallelProduct {
+	Limbs a, b;
+	size_t m;
+	future<Limbs> leaf;
+	vector<unique_ptr<ParallelProduct> > parts;   // z0, z2, z1
+
+	ParallelProduct(Limbs a, Limbs b, int depth, ThreadPool &pool) : a(move(a)), b(move(b)), m(0) {
+		if (this->a.size() < this->b.size())
+			swap(this->a, this->b);
+		size_t na = this->a.size(), nb = this->b.size();
+		if (depth == 0 || nb < PARALLEL_MUL_THRESHOLD || 2 * nb <= na) {
+			const Limbs &x = this->a, &y = this->b;
+			leaf = pool.submit([&x, &y] { return mulLimbs(x.data(), x.size(), y.data(), y.size()); });
+			return;
+		}
+		m = na / 2;
+		const uint32_t *pa = this->a.data(), *pb = this->b.data();
+		Limbs a0(pa, pa + m), b0(pb, pb + m);
+		trimLimbs(a0);
+		trimLimbs(b0);
+		parts.emplace_back(new ParallelProduct(a0, b0, depth - 1, pool));
+		parts.emplace_back(new ParallelProduct(Limbs(pa + m, pa + na), Limbs(pb + m, pb + nb), depth - 1, pool));
+		parts.emplace_back(new ParallelProduct(addLimbs(pa, m, pa + m, na - m),
+				addLimbs(pb, m, pb + m, nb - m), depth - 1, pool));
+	}
+
+	Limbs result() {
+		if (parts.empty())
+			return leaf.get();
+		Limbs z0 = parts[0]->result(), z2 = parts[1]->result(), z1 = parts[2]->result();
+		subInPlace(z1, z0);
+		subInPlace(z1, z2);
+		Limbs res(a.size() + b.size(), 0);
+		addShifted(res, z0, 0);
+		addShifted(res, z1, m);
+		addShifted(res, z2, 2 * m);
+		trimLimbs(res);
+		return res;
+	}
+};
+
+BigInt BigInt::multiply(const BigInt &a, const BigInt &b, ThreadPool &pool)
+{
+	BigInt res;
+	if (a.isZero() || b.isZero())
+		return res;
+	// 3^depth tarefas chegam para ocupar o pool
+	int depth = 0;
+	for (unsigned tasks = 1; tasks < pool.size() && depth < 4; tasks *= 3)
+		depth++;
+	ParallelProduct product(a.limbs, b.limbs, depth, pool);
+	res.limbs = product.result();
+	return res;
+}
+
+bool BigInt::operator==(const BigInt &other) const
+{
+	return limbs == other.limbs;
+}
+
+bool BigInt::operator!=(const BigInt &other) const
+{
+	return limbs != other.limbs;
+}
+
+bool BigInt::operator<(const BigInt &other) const
+{
+	if (limbs.size() != other.limbs.size())
+		return limbs.size() < other.limbs.size();
+	return lexicographical_compare(limbs.rbegin(), limbs.rend(), other.limbs.rbegin(), other.limbs.rend());
+}
+
+bool BigInt::isZero() const
+{
+	return limbs.empty();
+}
+
+uint32_t BigInt::mod(uint32_t m) const
+{
+	uint64_t rest = 0;
+	for (size_t i = limbs.size(); i-- > 0;)
+		rest = ((rest << 32) | limbs[i]) % m;
+	return (uint32_t) rest;
+}
+
+unsigned long long BigInt::low64() const
+{
+	unsigned long long res = 0;
+	if (limbs.size() > 0)
+		res = limbs[0];
+	if (limbs.size() > 1)
+		res |= (unsigned long long) limbs[1] << 32;
+	return res;
+}
+
+size_t BigInt::numLimbs() const
+{
+	return limbs.size();
+}
+
+string BigInt::toString() const
+{
+	if (isZero())
+		return "0";
+
+	// divisoes sucessivas por 10^9, guardando os grupos de 9 digitos
+	vector<uint32_t> rest(limbs);
+	vector<uint32_t> groups;
+	while (!rest.empty()) {
+		uint64_t r = 0;
+		for (size_t i = rest.size(); i-- > 0;) {
+			uint64_t cur = (r << 32) | rest[i];
+			rest[i] = (uint32_t) (cur / 1000000000);
+			r = cur % 1000000000;
+		}
+		groups.push_back((uint32_t) r);
+		while (!rest.empty() && rest.back() == 0)
+			rest.pop_back();
+	}
+
+	string res = to_string(groups.back());
+	for (size_t i = groups.size() - 1; i-- > 0;) {
+		string part = to_string(groups[i]);
+		res.append(9 - part.size(), '0');
+		res += part;
+	}
+	return res;
+}
+
+ostream& operator<<(ostream &os, const BigInt &n)
+{
+	return os << n.toString();
+}
@@ -0,0 +1,63 @@
+/*
+ * BigInt.h
+ */
+
+#ifndef BIGINT_H_
+#define BIGINT_H_
+
+#include "Defs.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/* Inteiro nao negativo de precisao arbitraria.
+ * Os digitos (limbs) de 32 bits ficam num unico vector contiguo, do menos para o
+ * mais significativo, sem zeros a esquerda (o zero e o vector vazio).
+ * As operacoes "in place" reutilizam a memoria ja reservada.
+ * A multiplicacao usa Karatsuba para operandos grandes.
+ */
+class BigInt {
+	vector<uint32_t> limbs;
+
+	void trim();
+public:
+	BigInt(unsigned long long value = 0);
+
+	BigInt& operator+=(const BigInt &other);
+	BigInt operator+(const BigInt &other) const;
+
+	/* *this = a + b, reutilizando a memoria ja reservada. */
+	void setSum(const BigInt &a, const BigInt &b);
+
+	/* Multiplicacao por um numero pequeno. */
+	BigInt& operator*=(uint32_t factor);
+	BigInt operator*(uint32_t factor) const;
+
+	BigInt operator*(const BigInt &other) const;
+
+	/* a * b, com os primeiros niveis da recursao de Karatsuba executados no pool. */
+	static BigInt multiply(const BigInt &a, const BigInt &b, ThreadPool &pool);
+
+	bool operator==(const BigInt &other) const;
+	bool operator!=(const BigInt &other) const;
+	bool operator<(const BigInt &other) const;
+
+	bool isZero() const;
+
+	/* Resto da divisao por m (m > 0). */
+	uint32_t mod(uint32_t m) const;
+
+	/* Os 64 bits menos significativos. */
+	unsigned long long low64() const;
+
+	/* Numero de limbs de 32 bits. */
+	size_t numLimbs() const;
+
+	/* Representacao decimal. */
+	string toString() const;
+};
+
+ostream& operator<<(ostream &os, const BigInt &n);
+
+#endif /* BIGINT_H_ */
@@ -3,32 +3,550 @@
  */
 
 #include "Change.h"
+#include "WavefrontDP.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// valor de minCoins para montantes impossiveis
+static const uint32_t UNREACHABLE = UINT32_MAX;
+
+// lastCoin guarda indice+1 em 16 bits
+static const size_t MAX_COINS = 65535;
 
 string calcChange(int m, int numCoins, int *coinValues)
 {
-    int minCoins[m+1]={0};
-    int lastCoin[m+1]={0};
+    ChangeMaker maker(numCoins, coinValues);
+    return maker.change(m);
+}
+
+ChangeMaker::ChangeMaker(int numCoins, int *coinValues)
+{
+    for (int i = 0; i < numCoins; i++)
+        if (coinValues[i] > 0)
+            coins.push_back(coinValues[i]);
+    sort(coins.begin(), coins.end());
+    coins.erase(unique(coins.begin(), coins.end()), coins.end());
+    if (coins.size() > MAX_COINS)
+        throw invalid_argument("ChangeMaker: more than 65535 different coins");
+
+    for (int c : coins)
+        coinText.push_back(to_string(c) + ";");
+
+    minCoins.push_back(0);
+    lastCoin.push_back(0);
+    run.push_back(0);
+    long long bound = coins.size() >= 2 ? (long long) (coins.back() - 1) * coins[coins.size() - 2] : 0;
+    queries = 0;
+    counterexample = findCounterexample();
+    // os indices da tabela sao int: acima de INT_MAX o limite deixa de ser o verdadeiro
+    periodBoundCapped = bound > INT_MAX;
+    periodBound = (int) min(bound, (long long) INT_MAX);
+}
+
+/* Teste de Pearson: com as moedas c1 > c2 > ... > cn = 1, para cada 1 < i <= j <= n
+ * parte-se da representacao gananciosa de c(i-1) - 1, mantem-se as moedas c1..cj,
+ * soma-se mais uma moeda cj e descarta-se o resto. Se o ganancioso usar mais moedas
+ * do que esta representacao para o mesmo valor w, w e um contra-exemplo; o menor
+ * contra-exemplo (se existir) e sempre um destes.
+ * Sem moeda de valor 1 o ganancioso pode nem encontrar troco: devolve 0. */
+int ChangeMaker::findCounterexample() const
+{
+    if (coins.empty() || coins[0] != 1)
+        return 0;
+
+    vector<int> desc(coins.rbegin(), coins.rend());
+    int n = desc.size();
+    long long best = -1;
+    vector<long long> greedy(n);
+    for (int i = 1; i < n; i++) {
+        long long rest = desc[i - 1] - 1;
+        for (int k = 0; k < n; k++) {
+            greedy[k] = rest / desc[k];
+            rest %= desc[k];
+        }
+        for (int j = i; j < n; j++) {
+            long long w = 0, count = 0;
+            for (int k = 0; k <= j; k++) {
+                w += greedy[k] * desc[k];
+                count += greedy[k];
+            }
+            w += desc[j];
+            count++;
+
+            long long greedyCount = 0;
+            rest = w;
+            for (int k = 0; k < n; k++) {
+                greedyCount += rest / desc[k];
+                rest %= desc[k];
+            }
+            if (greedyCount > count && (best < 0 || w < best))
+                best = w;
+        }
+    }
+    return (int) best;
+}
+
+string ChangeMaker::greedyChange(int m) const
+{
+    string res;
+    for (int i = (int) coins.size() - 1; i >= 0 && m > 0; i--) {
+        for (int count = m / coins[i]; count > 0; count--)
+            res += coinText[i];
+        m %= coins[i];
+    }
+    return res;
+}
+
+ChangeStats ChangeMaker::stats() const
+{
+    ChangeStats s;
+    s.path = counterexample < 0 ? CHANGE_GREEDY : CHANGE_TABLE;
+    s.canonical = counterexample < 0;
+    s.counterexample = counterexample > 0 ? counterexample : -1;
+    s.tableSize = tableSize();
+    s.periodBound = periodBound;
+    s.queries = queries;
+    return s;
+}
+
+int ChangeMaker::tableSize() const
+{
+    return (int) minCoins.size() - 1;
+}
+
+void ChangeMaker::grow(int m)
+{
+    int old = tableSize();
+    if (m <= old)
+        return;
+    // crescimento geometrico para que pedidos crescentes nao reconstruam tudo
+    if (m < 2LL * old)
+        m = (int) min(2LL * old, (long long) periodBound);
+
+    minCoins.resize(m + 1, UNREACHABLE);
+    lastCoin.resize(m + 1, 0);
+    run.resize(m + 1, 0);
+    int numCoins = coins.size();
+    for (int k = old + 1; k <= m; k++) {
+        uint32_t best = UNREACHABLE;
+        uint16_t last = 0;
+        // moedas maiores primeiro: em caso de empate fica a maior,
+        // e o troco sai por ordem decrescente
+        for (int i = numCoins - 1; i >= 0; i--) {
+            if (coins[i] > k || minCoins[k - coins[i]] == UNREACHABLE)
+                continue;
+            if (minCoins[k - coins[i]] + 1 < best) {
+                best = minCoins[k - coins[i]] + 1;
+                last = i + 1;
+            }
+        }
+        minCoins[k] = best;
+        lastCoin[k] = last;
+        if (last != 0) {
+            int prev = k - coins[last - 1];
+            run[k] = lastCoin[prev] == last ? run[prev] + 1 : 1;
+        }
+    }
+}
+
+/* Acima de periodBound ha sempre um troco optimo que usa a maior moeda, logo
+ * m = rest + extra * cmax com rest <= periodBound. Devolve rest (negativo se
+ * nao houver nenhum montante nessas condicoes, ou seja, se m for impossivel).
+ * Se periodBound foi limitado a INT_MAX, a reducao nao e valida: lanca out_of_range. */
+long long ChangeMaker::reduce(unsigned long long m, unsigned long long &extra) const
+{
+    extra = 0;
+    if (m <= (unsigned long long) periodBound)
+        return (long long) m;
+    if (periodBoundCapped)
+        throw out_of_range("ChangeMaker: amount above INT_MAX and periodBound does not fit in an int");
+    if (coins.empty())
+        return -1;
+    unsigned long long cmax = coins.back();
+    extra = (m - periodBound + cmax - 1) / cmax;
+    return (long long) (m - extra * cmax);
+}
+
+string ChangeMaker::change(int m)
+{
+    if (m < 0)
+        return "-";
+    queries++;
+    if (counterexample < 0)
+        return greedyChange(m);
+
+    unsigned long long extra;
+    long long rest = reduce(m, extra);
+    if (rest < 0)
+        return "-";
+    grow((int) rest);
+    if (minCoins[rest] == UNREACHABLE)
+        return "-";
+
     string res;
-    for(int i=0;i<numCoins;i++) {
-        for (int k = 0; k <= m; k++) {
-            if ((coinValues[i] <= k) && (minCoins[k - coinValues[i]] + 1 < minCoins[k] || minCoins[k] == 0)) {
-                minCoins[k] = minCoins[k - coinValues[i]] + 1;
-                lastCoin[k] = coinValues[i];
+    for (; extra > 0; extra--)
+        res += coinText.back();
+    while (rest > 0) {
+        int i = lastCoin[rest] - 1;
+        res += coinText[i];
+        rest -= coins[i];
+    }
+    return res;
+}
+
+bool ChangeMaker::changeCounts(unsigned long long m, vector<pair<int,unsigned long long> > &counts)
+{
+    counts.clear();
+    queries++;
+    if (counterexample < 0) {
+        for (int i = (int) coins.size() - 1; i >= 0 && m > 0; i--) {
+            if (m >= (unsigned long long) coins[i]) {
+                counts.push_back(make_pair(coins[i], m / coins[i]));
+                m %= coins[i];
+            }
+        }
+        return true;
+    }
+
+    unsigned long long extra;
+    long long rest = reduce(m, extra);
+    if (rest < 0)
+        return false;
+    grow((int) rest);
+    if (minCoins[rest] == UNREACHABLE)
+        return false;
+
+    if (extra > 0)
+        counts.push_back(make_pair(coins.back(), extra));
+    while (rest > 0) {
+        int i = lastCoin[rest] - 1;
+        unsigned long long count = run[rest];
+        if (!counts.empty() && counts.back().first == coins[i])
+            counts.back().second += count;
+        else
+            counts.push_back(make_pair(coins[i], count));
+        rest -= count * coins[i];
+    }
+    return true;
+}
+
+string ChangeMaker::changeCompressed(unsigned long long m)
+{
+    vector<pair<int,unsigned long long> > counts;
+    if (!changeCounts(m, counts))
+        return "-";
+    string res;
+    for (const pair<int,unsigned long long> &c : counts)
+        res += to_string(c.first) + "x" + to_string(c.second) + ";";
+    return res;
+}
+
+vector<string> ChangeMaker::change(const vector<int> &amounts)
+{
+    if (counterexample >= 0) {
+        int largest = 0;
+        for (int m : amounts)
+            largest = max(largest, m);
+        grow(min(largest, periodBound));
+    }
+
+    vector<string> res;
+    res.reserve(amounts.size());
+    for (int m : amounts)
+        res.push_back(change(m));
+    return res;
+}
+
+// montantes por cada copia do padrao de mascaras em countChange
+static const int MASK_PATTERN_AMOUNTS = 64;
+
+/* dst[i] = (dst[i] + (src[i] & mask[i])) mod p, com dst[i], src[i] < p < 2^31. */
+static void addModMasked(uint32_t *dst, const uint32_t *src, const uint32_t *mask, int len, uint32_t p)
+{
+    int i = 0;
+#ifdef __AVX2__
+    const __m256i vp = _mm256_set1_epi32(p);
+    for (; i + 8 <= len; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (dst + i));
+        __m256i b = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) (src + i)),
+                _mm256_loadu_si256((const __m256i*) (mask + i)));
+        __m256i s = _mm256_add_epi32(a, b);
+        // se s >= p, s - p e o menor dos dois; senao s - p da a volta e fica maior
+        s = _mm256_min_epu32(s, _mm256_sub_epi32(s, vp));
+        _mm256_storeu_si256((__m256i*) (dst + i), s);
+    }
+#endif
+    for (; i < len; i++) {
+        uint32_t s = dst[i] + (src[i] & mask[i]);
+        dst[i] = s >= p ? s - p : s;
+    }
+}
+
+unsigned countChange(int m, int numCoins, int *coinValues, unsigned p)
+{
+    vector<vector<int> > systems(1, vector<int>(coinValues, coinValues + numCoins));
+    return countChange(m, systems, p)[0];
+}
+
+vector<unsigned> countChange(int m, const vector<vector<int> > &coinSystems, unsigned p)
+{
+    size_t numSystems = coinSystems.size();
+    vector<unsigned> res(numSystems, 0);
+    if (numSystems == 0 || m < 0 || p == 0 || p > (1u << 31))
+        return res;
+
+    vector<vector<int> > systems(coinSystems);
+    vector<int> values;
+    for (vector<int> &sys : systems) {
+        sort(sys.begin(), sys.end());
+        sys.erase(unique(sys.begin(), sys.end()), sys.end());
+        for (int c : sys)
+            if (c > 0 && c <= m)
+                values.push_back(c);
+    }
+    sort(values.begin(), values.end());
+    values.erase(unique(values.begin(), values.end()), values.end());
+
+    // ways[k * numSystems + s]: formas de obter k no sistema s
+    vector<uint32_t> ways((size_t) (m + 1) * numSystems, 0);
+    for (size_t s = 0; s < numSystems; s++)
+        ways[s] = 1 % p;
+
+    vector<uint32_t> pattern(MASK_PATTERN_AMOUNTS * numSystems);
+    for (int c : values) {
+        for (size_t s = 0; s < numSystems; s++) {
+            uint32_t mask = binary_search(systems[s].begin(), systems[s].end(), c) ? 0xFFFFFFFFu : 0;
+            for (int r = 0; r < MASK_PATTERN_AMOUNTS; r++)
+                pattern[r * numSystems + s] = mask;
+        }
+
+        size_t stride = (size_t) c * numSystems;
+        size_t total = (size_t) (m + 1) * numSystems;
+        if (stride < 16) {
+            // moedas pequenas: a dependencia e curta demais para vectorizar
+            for (size_t i = stride, s = 0; i < total; i++) {
+                uint32_t v = ways[i] + (ways[i - stride] & pattern[s]);
+                ways[i] = v >= p ? v - p : v;
+                if (++s == numSystems)
+                    s = 0;
+            }
+            continue;
+        }
+        // blocos de c montantes: cada bloco so depende do anterior, ja terminado
+        for (long long k = c; k <= m; k += c) {
+            long long blockEnd = min((long long) k + c, (long long) m + 1);
+            for (long long j = k; j < blockEnd; j += MASK_PATTERN_AMOUNTS) {
+                int amounts = (int) min((long long) MASK_PATTERN_AMOUNTS, blockEnd - j);
+                addModMasked(&ways[j * numSystems], &ways[(j - c) * numSystems], pattern.data(),
+                        amounts * numSystems, p);
             }
         }
     }
 
-    while (m>0) {
-        res += to_string(lastCoin[m]) + ";";
+    for (size_t s = 0; s < numSystems; s++)
+        res[s] = ways[(size_t) m * numSystems + s];
+    return res;
+}
+
+/* Celula da tabela de calcChangeParallel: linha i = moedas 0..i, coluna = montante. */
+struct ChangeCell {
+    uint32_t count;     // numero minimo de moedas (UNREACHABLE se impossivel)
+    uint32_t last;      // indice+1 da maior moeda usada (o struct tem 8 bytes de qualquer forma)
+};
+
+string calcChangeParallel(int m, int numCoins, int *coinValues, unsigned numThreads)
+{
+    if (m < 0)
+        return "-";
+    vector<int> coins;
+    for (int i = 0; i < numCoins; i++)
+        if (coinValues[i] > 0)
+            coins.push_back(coinValues[i]);
+    sort(coins.begin(), coins.end());
+    coins.erase(unique(coins.begin(), coins.end()), coins.end());
+    if (coins.empty())
+        return m == 0 ? "" : "-";
+
+    // linha i: min(linha i-1, linha i no montante j - c + 1 moeda); em caso de empate
+    // fica a moeda maior, como no ChangeMaker
+    const ChangeCell outside = {UNREACHABLE, 0};
+    auto recurrence = [&coins](int i, int j, const ChangeCell &up, const ChangeCell &,
+            const WavefrontRow<ChangeCell> &left) {
+        if (j == 0)
+            return ChangeCell{0, 0};
+        ChangeCell best = up;
+        int c = coins[i];
+        if (j >= c && left(c).count != UNREACHABLE && left(c).count + 1 <= best.count)
+            best = ChangeCell{left(c).count + 1, (uint32_t) (i + 1)};
+        return best;
+    };
+    int cmax = coins.back();
+    vector<ChangeCell> table = wavefront(coins.size(), m + 1, recurrence, outside, cmax,
+            1, max(4096, cmax), numThreads);
+
+    if (table[m].count == UNREACHABLE)
+        return "-";
+    string res;
+    for (int rest = m; rest > 0; ) {
+        int i = table[rest].last - 1;
+        res += to_string(coins[i]) + ";";
+        rest -= coins[i];
+    }
+    return res;
+}
+
+string calcChangeBounded(int m, int numCoins, int *coinValues, int *coinCounts)
+{
+    BoundedChangeMaker maker(numCoins, coinValues, coinCounts);
+    return maker.change(m);
+}
+
+BoundedChangeMaker::BoundedChangeMaker(int numCoins, int *coinValues, int *coinCounts)
+{
+    vector<pair<int,int> > sorted;
+    // moedas sem stock ficam na tabela, para poderem ser repostas com addStock
+    for (int i = 0; i < numCoins; i++)
+        if (coinValues[i] > 0)
+            sorted.push_back(make_pair(coinValues[i], max(0, coinCounts[i])));
+    sort(sorted.begin(), sorted.end());
+
+    for (const pair<int,int> &c : sorted) {
+        if (!coins.empty() && coins.back() == c.first) {
+            stock.back() += c.second;
+            continue;
+        }
+        coins.push_back(c.first);
+        stock.push_back(c.second);
+        coinText.push_back(to_string(c.first) + ";");
+    }
+
+    minCoins.resize(coins.size());
+    taken.resize(coins.size());
+    capacity = -1;
+    validLayers = 0;
+}
+
+int BoundedChangeMaker::coinIndex(int value) const
+{
+    vector<int>::const_iterator it = lower_bound(coins.begin(), coins.end(), value);
+    if (it == coins.end() || *it != value)
+        return -1;
+    return it - coins.begin();
+}
+
+int BoundedChangeMaker::getStock(int coinValue) const
+{
+    int i = coinIndex(coinValue);
+    return i < 0 ? 0 : stock[i];
+}
+
+void BoundedChangeMaker::addStock(int coinValue, int count)
+{
+    int i = coinIndex(coinValue);
+    if (i < 0 || count == 0)
+        return;
+    stock[i] = max(0, stock[i] + count);
+    invalidateFrom(i);
+}
 
-        if(lastCoin[m] ==0) {
-            res = "-";
-            break;
+void BoundedChangeMaker::invalidateFrom(int i)
+{
+    validLayers = min(validLayers, i);
+}
+
+/* minCoins[i][k] = min { minCoins[i-1][k - t*c] + t : 0 <= t <= stock[i] }.
+ * Para cada residuo r, com k = r + j*c, e o minimo de (minCoins[i-1][r + j'*c] - j') + j
+ * para j - stock <= j' <= j: minimo numa janela deslizante, mantido numa fila monotona. */
+void BoundedChangeMaker::computeLayer(int i)
+{
+    int c = coins[i];
+    long long q = stock[i];
+    vector<uint32_t> &cur = minCoins[i];
+    vector<uint32_t> &cnt = taken[i];
+    cur.assign(capacity + 1, UNREACHABLE);
+    cnt.assign(capacity + 1, 0);
+
+    vector<uint32_t> first;
+    if (i == 0) {
+        first.assign(capacity + 1, UNREACHABLE);
+        first[0] = 0;
+    }
+    const vector<uint32_t> &prev = i == 0 ? first : minCoins[i - 1];
+
+    vector<int> window(capacity / c + 1);   // fila monotona de indices j'
+    for (int r = 0; r < c && r <= capacity; r++) {
+        int head = 0, tail = 0;
+        for (int j = 0, k = r; k <= capacity; j++, k += c) {
+            if (prev[k] != UNREACHABLE) {
+                long long value = (long long) prev[k] - j;
+                // em caso de empate fica o indice mais antigo (mais moedas deste valor)
+                while (tail > head && (long long) prev[r + window[tail - 1] * c] - window[tail - 1] > value)
+                    tail--;
+                window[tail++] = j;
+            }
+            while (tail > head && window[head] < j - q)
+                head++;
+            if (tail > head) {
+                int best = window[head];
+                cur[k] = prev[r + best * c] + (j - best);
+                cnt[k] = j - best;
+            }
         }
-        m -= lastCoin[m];
     }
+}
 
+void BoundedChangeMaker::update(int m)
+{
+    if (m > capacity) {
+        capacity = max(m, 2 * capacity);
+        validLayers = 0;
+    }
+    for (; validLayers < (int) coins.size(); validLayers++)
+        computeLayer(validLayers);
+}
+
+string BoundedChangeMaker::change(int m)
+{
+    if (m < 0)
+        return "-";
+    if (m == 0)
+        return "";
+    if (coins.empty())
+        return "-";
+    update(m);
+    int top = coins.size() - 1;
+    if (minCoins[top][m] == UNREACHABLE)
+        return "-";
+
+    string res;
+    for (int i = top; i >= 0 && m > 0; i--) {
+        int t = taken[i][m];
+        for (int n = 0; n < t; n++)
+            res += coinText[i];
+        m -= t * coins[i];
+    }
     return res;
 }
 
+string BoundedChangeMaker::dispense(int m)
+{
+    string res = change(m);
+    if (res.empty() || res == "-")
+        return res;
 
+    int lowest = coins.size();
+    for (int i = coins.size() - 1; i >= 0 && m > 0; i--) {
+        int t = taken[i][m];
+        if (t > 0) {
+            stock[i] -= t;
+            lowest = i;
+        }
+        m -= t * coins[i];
+    }
+    invalidateFrom(lowest);
+    return res;
+}
@@ -6,6 +6,8 @@
 #define CHANGE_H_
 
 #include "Defs.h"
+#include <cstdint>
+#include <vector>
 
 /* Calcula o troco num determinado montante m, utilizando um nmero mnimo
  * de moedas de valores unitrios indicados (coinValues).
@@ -17,4 +19,148 @@
  * */
 string calcChange(int m, int numCoins, int *coinValues);
 
+/* Caminho usado por um ChangeMaker para responder aos pedidos. */
+enum ChangePath {
+	CHANGE_GREEDY,   // sistema canonico: algoritmo ganancioso, sem tabela
+	CHANGE_TABLE     // programacao dinamica sobre minCoins/lastCoin
+};
+
+/* Estatisticas de um ChangeMaker. */
+struct ChangeStats {
+	ChangePath path;
+	bool canonical;           // o ganancioso e optimo para qualquer montante
+	int counterexample;       // menor montante onde o ganancioso falha (-1 se nao houver)
+	int tableSize;            // maior montante presente na tabela
+	int periodBound;          // a tabela nunca passa deste montante
+	long long queries;        // pedidos respondidos
+};
+
+/* Calculo de trocos repetido sobre o mesmo sistema de moedas.
+ *
+ * Na construcao verifica-se (teste de Pearson, O(n^3)) se o sistema e canonico.
+ * Se for, os pedidos sao respondidos pelo algoritmo ganancioso em O(numCoins).
+ * Senao, as tabelas minCoins/lastCoin sao construidas uma unica vez, no heap, e so
+ * crescem quando e pedido um montante maior do que os ja calculados.
+ *
+ * A tabela nunca passa de periodBound = (cmax - 1) * c2, sendo cmax a maior moeda e c2
+ * a segunda maior: um troco optimo usa sempre menos de cmax moedas diferentes de cmax,
+ * logo acima desse limite basta juntar moedas cmax ao troco de um montante da tabela.
+ * A memoria fica em O(cmax^2) e qualquer montante de 64 bits tem resposta.
+ *
+ * change() custa O(numero de moedas devolvidas); changeCounts() custa O(numCoins).
+ * O formato das respostas de change() e o mesmo de calcChange.
+ * Se (cmax - 1) * c2 nao couber num int, periodBound fica limitado a INT_MAX: change()
+ * continua a responder a qualquer montante int, mas nos sistemas nao canonicos
+ * changeCounts() e changeCompressed() lancam out_of_range acima de INT_MAX.
+ * O construtor lanca invalid_argument com mais de 65535 moedas diferentes (lastCoin tem 16 bits).
+ */
+class ChangeMaker {
+	vector<int> coins;             // valores das moedas, por ordem crescente
+	vector<string> coinText;       // "valor;" de cada moeda
+	vector<uint32_t> minCoins;     // numero minimo de moedas para cada montante
+	vector<uint16_t> lastCoin;     // indice+1 da ultima moeda usada (0 = impossivel; ate 65535 moedas)
+	vector<uint32_t> run;          // quantas moedas lastCoin seguidas tem o troco
+	int periodBound;
+	bool periodBoundCapped;        // (cmax - 1) * c2 > INT_MAX: periodBound e so INT_MAX
+
+	int counterexample;            // -1: canonico; 0: sem moeda 1; senao, o menor contra-exemplo
+	long long queries;
+
+	void grow(int m);
+	int findCounterexample() const;
+	string greedyChange(int m) const;
+	long long reduce(unsigned long long m, unsigned long long &extra) const;
+public:
+	ChangeMaker(int numCoins, int *coinValues);
+
+	/* Troco para o montante m ("-" se for impossivel). */
+	string change(int m);
+
+	/* Troco para cada um dos montantes (a tabela cresce no maximo uma vez). */
+	vector<string> change(const vector<int> &amounts);
+
+	/* Troco para um montante de 64 bits, na forma comprimida: pares (moeda, quantidade)
+	 * por ordem decrescente de moeda. Devolve false se o troco for impossivel. */
+	bool changeCounts(unsigned long long m, vector<pair<int,unsigned long long> > &counts);
+
+	/* O mesmo que changeCounts, como string "moedaxquantidade;..."
+	 * Por exemplo: changeCompressed(1000000007) com {1, 4, 5} = "5x199999999;4x3;"
+	 * Devolve "-" se o troco for impossivel. */
+	string changeCompressed(unsigned long long m);
+
+	/* Maior montante ja presente na tabela. */
+	int tableSize() const;
+
+	/* Caminho escolhido e contadores de utilizacao. */
+	ChangeStats stats() const;
+};
+
+/* Numero de formas distintas (sem contar a ordem) de obter o montante m com as moedas
+ * indicadas, modulo p. O p deve ser primo e inferior a 2^31.
+ * Por exemplo: countChange(5, 3, {1, 2, 5}, 1000000007) = 4
+ */
+unsigned countChange(int m, int numCoins, int *coinValues, unsigned p);
+
+/* O mesmo que countChange, para varios sistemas de moedas de uma vez.
+ * As tabelas dos varios sistemas ficam intercaladas em memoria, e cada valor de moeda
+ * (de qualquer sistema) da uma unica passagem sobre ela, somando apenas nos sistemas
+ * que tem essa moeda. A soma modular e vectorizada.
+ */
+vector<unsigned> countChange(int m, const vector<vector<int> > &coinSystems, unsigned p);
+
+/* Como calcChange, mas com um numero limitado de moedas de cada valor:
+ * coinCounts[i] indica quantas moedas de valor coinValues[i] existem.
+ */
+string calcChangeBounded(int m, int numCoins, int *coinValues, int *coinCounts);
+
+/* Como calcChange, mas preenchendo a tabela completa (moedas x montantes 0..m) com o
+ * executor em frente de onda (WavefrontDP.h), em numThreads threads (0 = numero de cores).
+ * Nao usa o teste de canonicidade nem o limite periodBound do ChangeMaker: serve para
+ * montantes em que a tabela inteira e precisa, ou para comparar resultados.
+ * A resposta e a mesma de calcChange.
+ */
+string calcChangeParallel(int m, int numCoins, int *coinValues, unsigned numThreads = 0);
+
+/* Calculo de trocos com stock limitado de moedas (por exemplo, uma maquina de trocos).
+ *
+ * A tabela tem uma camada por moeda: minCoins[i][k] e o numero minimo de moedas para o
+ * montante k usando so as moedas 0..i (dentro do stock), e taken[i][k] quantas moedas i
+ * foram usadas. Cada camada e calculada por residuo modulo o valor da moeda, com uma fila
+ * monotona (minimo em janela deslizante), o que custa O(m) independentemente do stock;
+ * o total e O(m * numCoins).
+ *
+ * A tabela e reutilizada enquanto o stock nao mudar. Quando muda o stock de uma moeda,
+ * so as camadas dessa moeda em diante sao recalculadas (no pedido seguinte).
+ */
+class BoundedChangeMaker {
+	vector<int> coins;                    // valores das moedas, por ordem crescente
+	vector<int> stock;                    // moedas disponiveis de cada valor
+	vector<string> coinText;              // "valor;" de cada moeda
+	vector<vector<uint32_t> > minCoins;
+	vector<vector<uint32_t> > taken;
+	int capacity;                         // maior montante na tabela
+	int validLayers;                      // camadas 0..validLayers-1 estao actualizadas
+
+	void update(int m);
+	void computeLayer(int i);
+	void invalidateFrom(int i);
+	int coinIndex(int value) const;
+public:
+	BoundedChangeMaker(int numCoins, int *coinValues, int *coinCounts);
+
+	/* Troco para o montante m ("-" se for impossivel com o stock actual).
+	 * Nao altera o stock. */
+	string change(int m);
+
+	/* Igual a change, mas retira do stock as moedas entregues. */
+	string dispense(int m);
+
+	/* Acrescenta (ou retira, se count < 0) moedas de um dos valores dados ao construtor,
+	 * mesmo que tenha comecado sem stock. */
+	void addStock(int coinValue, int count);
+
+	/* Numero de moedas disponiveis de um valor. */
+	int getStock(int coinValue) const;
+};
+
 #endif /* CHANGE_H_ */
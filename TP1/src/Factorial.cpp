@@ -3,21 +3,97 @@
  */
 
 #include "Factorial.h"
-#include <iostream>
+#include "Tables.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+// numeros consecutivos multiplicados em cada folha da arvore de produtos
+static const int FACTORIAL_LEAF = 256;
+// abaixo disto o produto e calculado na thread que chama, sem criar um pool
+static const int FACTORIAL_PARALLEL_MIN = 16 * FACTORIAL_LEAF;
+
 int factorialRecurs(int n)
 {
-	if(n ==1)
-		return 1;
-	else
-		return n*factorialRecurs(n-1);
-
+	if (n <= FACTORIAL_TABLE_MAX)
+		return (int) factorialTable.value[n < 0 ? 0 : n];
+	return (int) factorialBig(n).low64();
 }
 
 int factorialDinam(int n)
 {
-	int a = 1;
-	for(int i =0; i<n;i++) {
-		a *= (n-i);
+	if (n <= FACTORIAL_TABLE_MAX)
+		return (int) factorialTable.value[n < 0 ? 0 : n];
+	return (int) factorialBig(n).low64();
+}
+
+/* lo * (lo+1) * ... * hi, juntando varios factores enquanto cabem em 32 bits. */
+static BigInt rangeProduct(long long lo, long long hi)
+{
+	BigInt res(1);
+	uint64_t acc = 1;
+	for (long long i = lo; i <= hi; i++) {
+		if (acc * i > UINT32_MAX) {
+			res *= (uint32_t) acc;
+			acc = 1;
+		}
+		acc *= i;
 	}
-	return a;
+	res *= (uint32_t) acc;
+	return res;
+}
+
+/* A mesma arvore de produtos, sequencial. */
+static BigInt treeProduct(long long lo, long long hi)
+{
+	if (hi - lo < FACTORIAL_LEAF)
+		return rangeProduct(lo, hi);
+	long long mid = lo + (hi - lo) / 2;
+	return treeProduct(lo, mid) * treeProduct(mid + 1, hi);
+}
+
+BigInt factorialBig(int n, unsigned numThreads)
+{
+	if (n <= FACTORIAL_TABLE_MAX)
+		return BigInt(factorialTable.value[n < 0 ? 0 : n]);
+	if (n < FACTORIAL_PARALLEL_MIN || numThreads == 1)
+		return treeProduct(2, n);
+
+	ThreadPool pool(numThreads);
+	vector<future<BigInt> > pending;
+	for (long long lo = 2; lo <= n; lo += FACTORIAL_LEAF) {
+		long long hi = min((long long) n, lo + FACTORIAL_LEAF - 1);
+		pending.push_back(pool.submit([lo, hi] { return rangeProduct(lo, hi); }));
+	}
+	vector<BigInt> level;
+	for (future<BigInt> &f : pending)
+		level.push_back(f.get());
+
+	while (level.size() > 1) {
+		vector<BigInt> next((level.size() + 1) / 2);
+		if (next.size() >= pool.size()) {
+			// produtos suficientes para ocupar o pool: um por tarefa
+			vector<future<BigInt> > products;
+			for (size_t i = 0; i + 1 < level.size(); i += 2) {
+				const BigInt &a = level[i], &b = level[i + 1];
+				products.push_back(pool.submit([&a, &b] { return a * b; }));
+			}
+			for (size_t i = 0; i < products.size(); i++)
+				next[i] = products[i].get();
+		}
+		else {
+			for (size_t i = 0; i + 1 < level.size(); i += 2)
+				next[i / 2] = BigInt::multiply(level[i], level[i + 1], pool);
+		}
+		if (level.size() % 2 == 1)
+			next.back() = level.back();
+		level.swap(next);
+	}
+	return level[0];
+}
+
+long long factorialDigits(int n)
+{
+	if (n <= FACTORIAL_TABLE_MAX)
+		return to_string(factorialTable.value[n < 0 ? 0 : n]).size();
+	return (long long) floor(lgamma(n + 1.0) / log(10.0)) + 1;
 }
@@ -6,6 +6,7 @@
 #define FACTORIAL_H_
 
 #include "Defs.h"
+#include "BigInt.h"
 
 /*Calcula o factorial de um valor de entrada n (>=0) usando recursividade*/
 int factorialRecurs(int n);
@@ -13,5 +14,18 @@ int factorialRecurs(int n);
 /*Calcula o factorial de um valor de entrada n (>=0) usando programao dinmica*/
 int factorialDinam(int n);
 
+/* Factorial exacto de n (>=0). Ate 20! e uma consulta a tabela calculada
+ * em tempo de compilacao (Tables.h).
+ * Acima disso multiplica os numeros 2..n numa arvore de produtos (divisao binaria):
+ * as folhas e os produtos de cada nivel sao tarefas independentes de um pool de
+ * numThreads threads (0 = numero de cores), e nos ultimos niveis, com poucos
+ * produtos muito grandes, e a propria multiplicacao (Karatsuba) que se divide pelo pool.
+ * Para n pequeno (ou numThreads == 1) a arvore e calculada na thread que chama, sem pool.
+ */
+BigInt factorialBig(int n, unsigned numThreads = 0);
+
+/* Numero de digitos decimais de n!, sem calcular n! (via lgamma). */
+long long factorialDigits(int n);
+
 
 #endif /* FACTORIAL_H_ */
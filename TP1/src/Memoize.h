@@ -0,0 +1,193 @@
+/*
+ * Memoize.h
+ */
+
+#ifndef MEMOIZE_H_
+#define MEMOIZE_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+using namespace std;
+
+/* Limites (exclusivos) de cada argumento inteiro, conhecidos em tempo de compilacao:
+ * memoize<int(int,int), DenseBounds<64,64> > guarda os resultados de 0 <= n,k < 64
+ * num array denso; fora desses limites ficam numa tabela de hash, como sem limites.
+ */
+template <int... Extents>
+struct DenseBounds {};
+
+/* Memoizacao de uma funcao recursiva.
+ *
+ * O corpo recebe o proprio objecto como primeiro argumento, para as chamadas recursivas:
+ *
+ *   memoize<int(int,int)> s([](memoize<int(int,int)> &s, int n, int k) {
+ *       return k == 1 || k == n ? 1 : s(n-1, k-1) + k * s(n-1, k);
+ *   });
+ *
+ * Sem limites, os resultados ficam numa tabela de hash dividida em shards, cada uma
+ * com o seu mutex. Com DenseBounds ficam num array, sem locks (um estado atomico por
+ * entrada), e so os argumentos fora dos limites vao para a tabela de hash.
+ * Em ambos os casos pode ser chamado por varias threads ao mesmo tempo; o corpo e
+ * calculado fora de qualquer lock, por isso duas threads podem ocasionalmente
+ * calcular o mesmo valor, mas so um fica guardado.
+ */
+template <class Signature, class Bounds = void>
+class memoize;
+
+/* Hash de um tuplo, combinando os hashes dos elementos. */
+template <class Tuple>
+struct TupleHash {
+	template <size_t... I>
+	static size_t combine(const Tuple &t, index_sequence<I...>) {
+		size_t seed = 0;
+		int unused[] = { 0, (seed ^= hash<typename tuple_element<I, Tuple>::type>()(get<I>(t))
+				+ (size_t) 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2), 0)... };
+		(void) unused;
+		return seed;
+	}
+
+	size_t operator()(const Tuple &t) const {
+		return combine(t, make_index_sequence<tuple_size<Tuple>::value>());
+	}
+};
+
+/* Tabela de hash dividida em shards, cada uma com o seu mutex. */
+template <class Key, class R>
+class ShardedMap {
+	static const size_t NUM_SHARDS = 64;
+
+	struct Shard {
+		mutex lock;
+		unordered_map<Key, R, TupleHash<Key> > values;
+	};
+
+	unique_ptr<Shard[]> shards;
+
+	Shard& shardOf(const Key &key) { return shards[TupleHash<Key>()(key) % NUM_SHARDS]; }
+public:
+	ShardedMap() : shards(new Shard[NUM_SHARDS]) {}
+
+	bool find(const Key &key, R &value) {
+		Shard &shard = shardOf(key);
+		lock_guard<mutex> guard(shard.lock);
+		typename unordered_map<Key, R, TupleHash<Key> >::const_iterator it = shard.values.find(key);
+		if (it == shard.values.end())
+			return false;
+		value = it->second;
+		return true;
+	}
+
+	/* Guarda value, se a chave ainda nao existir; devolve o valor guardado. */
+	R insert(const Key &key, const R &value) {
+		Shard &shard = shardOf(key);
+		lock_guard<mutex> guard(shard.lock);
+		return shard.values.emplace(key, value).first->second;
+	}
+
+	size_t size() {
+		size_t total = 0;
+		for (size_t i = 0; i < NUM_SHARDS; i++) {
+			lock_guard<mutex> guard(shards[i].lock);
+			total += shards[i].values.size();
+		}
+		return total;
+	}
+};
+
+template <class R, class... Args>
+class memoize<R(Args...), void> {
+	typedef tuple<typename decay<Args>::type...> Key;
+
+	function<R(memoize&, Args...)> body;
+	ShardedMap<Key, R> values;
+public:
+	template <class F>
+	explicit memoize(F f) : body(f) {}
+
+	R operator()(Args... args) {
+		Key key(args...);
+		R value;
+		if (values.find(key, value))
+			return value;
+		// fora do lock: as chamadas recursivas podem cair na mesma shard
+		return values.insert(key, body(*this, args...));
+	}
+
+	/* Numero de resultados guardados. */
+	size_t size() { return values.size(); }
+};
+
+template <class R, class... Args, int... Extents>
+class memoize<R(Args...), DenseBounds<Extents...> > {
+	static_assert(sizeof...(Args) == sizeof...(Extents), "DenseBounds precisa de um limite por argumento");
+
+	enum { EMPTY, BUSY, READY };
+
+	struct Slot {
+		atomic<unsigned char> state;
+		R value;
+		Slot() : state(EMPTY), value() {}
+	};
+
+	typedef tuple<typename decay<Args>::type...> Key;
+
+	function<R(memoize&, Args...)> body;
+	unique_ptr<Slot[]> slots;
+	ShardedMap<Key, R> outside;    // argumentos fora dos limites
+
+	static constexpr size_t capacity() {
+		const int extents[] = { Extents... };
+		size_t total = 1;
+		for (int e : extents)
+			total *= e;
+		return total;
+	}
+
+	/* Posicao no array (ordem "row-major"); false se algum argumento sair dos limites. */
+	static bool position(size_t &pos, Args... args) {
+		const long long values[] = { (long long) args... };
+		const int extents[] = { Extents... };
+		pos = 0;
+		for (size_t i = 0; i < sizeof...(Args); i++) {
+			if (values[i] < 0 || values[i] >= extents[i])
+				return false;
+			pos = pos * extents[i] + values[i];
+		}
+		return true;
+	}
+public:
+	template <class F>
+	explicit memoize(F f) : body(f), slots(new Slot[capacity()]) {}
+
+	R operator()(Args... args) {
+		size_t pos;
+		if (!position(pos, args...)) {
+			Key key(args...);
+			R value;
+			if (outside.find(key, value))
+				return value;
+			return outside.insert(key, body(*this, args...));
+		}
+
+		Slot &slot = slots[pos];
+		if (slot.state.load(memory_order_acquire) == READY)
+			return slot.value;
+		// quem conseguir marcar a entrada e quem a escreve; os outros so calculam
+		unsigned char expected = EMPTY;
+		bool owner = slot.state.compare_exchange_strong(expected, (unsigned char) BUSY);
+		R value = body(*this, args...);
+		if (owner) {
+			slot.value = value;
+			slot.state.store(READY, memory_order_release);
+		}
+		return value;
+	}
+};
+
+#endif /* MEMOIZE_H_ */
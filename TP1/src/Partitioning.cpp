@@ -3,14 +3,14 @@
  */
 
 #include "Partitioning.h"
+#include "Tables.h"
+#include "Memoize.h"
+#include "WavefrontDP.h"
 
 
 int s_recursive(int n,int k)
 {
-	if (k == 1 || k == n)
-		return 1;
-	else
-		return s_recursive(n-1,k-1) + k* s_recursive(n-1,k);
+	return (int) stirlingBig(n, k).low64();
 }
 
 int s_dynamic(int n,int k)
@@ -25,21 +25,145 @@ int s_dynamic(int n,int k)
 }
 
 
+/* b_recursive e b_dynamic mantem b(0) = 0, a soma vazia das versoes originais
+ * (bellBig e bellNumbers dao B0 = 1). */
 int b_recursive(int n)
 {
-	int b =0;
-	for(int i=1; i <= n; i++)
-		b += s_recursive(n,i);
-	return b;
+	if (n <= 0)
+		return 0;
+	return (int) bellBig(n).low64();
 }
 
 int b_dynamic(int n)
 {
-    int bell =0;
-    for(int i = 1; i <= n; i++) {
-        bell += s_dynamic(n, i);
+    if (n <= 0)
+        return 0;
+    return (int) bellNumbers(n)[n].low64();
+}
+
+vector<BigInt> s_dynamic(int n)
+{
+    if (n < 0)
+        return vector<BigInt>();
+    vector<BigInt> row(n + 1);
+    row[0] = 1;
+    // linha i a partir da linha i-1, da direita para a esquerda:
+    // s(i,k) = k*s(i-1,k) + s(i-1,k-1)
+    for (int i = 1; i <= n; i++) {
+        for (int k = i; k >= 1; k--) {
+            row[k] *= k;
+            row[k] += row[k - 1];
+        }
+        row[0] = 0;
     }
-	return bell;
+    return row;
 }
 
+vector<unsigned> s_dynamicMod(int n, unsigned p, unsigned numThreads)
+{
+    if (n < 0)
+        return vector<unsigned>();
+    auto recurrence = [p](int i, int k, const unsigned &up, const unsigned &diag,
+            const WavefrontRow<unsigned> &) {
+        if (i == 0)
+            return k == 0 ? 1 % p : 0u;
+        return (unsigned) ((diag + (unsigned long long) k * up) % p);
+    };
+    return wavefront(n + 1, n + 1, recurrence, 0u, 1, 64, 256, numThreads);
+}
+
+/* Triangulo de Bell: cada linha comeca no ultimo elemento da anterior e
+ * a(i,j) = a(i,j-1) + a(i-1,j-1); o primeiro elemento da linha i e b(i). */
+vector<BigInt> bellNumbers(int n)
+{
+    if (n < 0)
+        return vector<BigInt>();
+    vector<BigInt> bell(n + 1);
+    vector<BigInt> prev(n + 1), cur(n + 1);
+    bell[0] = 1;
+    prev[0] = 1;
+    for (int i = 1; i <= n; i++) {
+        cur[0] = prev[i - 1];
+        for (int j = 1; j <= i; j++)
+            cur[j].setSum(cur[j - 1], prev[j - 1]);
+        bell[i] = cur[0];
+        swap(prev, cur);
+    }
+    return bell;
+}
+
+vector<unsigned> bellNumbersMod(int n, unsigned p)
+{
+    if (n < 0 || p == 0)
+        return vector<unsigned>();
+    vector<unsigned> bell(n + 1);
+    vector<unsigned long long> row(n + 1), next(n + 1);
+    bell[0] = 1 % p;
+    row[0] = 1 % p;
+    for (int i = 1; i <= n; i++) {
+        next[0] = row[i - 1];
+        for (int j = 1; j <= i; j++) {
+            next[j] = next[j - 1] + row[j - 1];
+            if (next[j] >= p)
+                next[j] -= p;
+        }
+        bell[i] = (unsigned) next[0];
+        swap(row, next);
+    }
+    return bell;
+}
 
+
+
+BigInt stirlingBig(int n, int k)
+{
+    if (n < 0 || k < 0 || k > n)
+        return BigInt(0);
+    if (n <= PARTITION_TABLE_MAX)
+        return BigInt(partitionTable.stirling[n][k]);
+    return s_dynamic(n)[k];
+}
+
+BigInt bellBig(int n)
+{
+    if (n < 0)
+        return BigInt(0);
+    if (n <= PARTITION_TABLE_MAX)
+        return BigInt(partitionTable.bell[n]);
+    return bellNumbers(n)[n];
+}
+
+typedef memoize<unsigned(int,int), DenseBounds<128,128> > StirlingMemo;
+typedef memoize<unsigned(int,int)> BellTriangleMemo;
+
+int s_memoized(int n, int k)
+{
+    static StirlingMemo s([](StirlingMemo &s, int n, int k) -> unsigned {
+        if (k < 0 || k > n)
+            return 0;
+        if (k == n)
+            return 1;
+        if (k == 0)
+            return 0;
+        return s(n - 1, k - 1) + k * s(n - 1, k);
+    });
+    return (int) s(n, k);
+}
+
+int b_memoized(int n)
+{
+    // a(i,0) = a(i-1,i-1), a(i,j) = a(i,j-1) + a(i-1,j-1); b(i) = a(i,0)
+    static BellTriangleMemo a([](BellTriangleMemo &a, int i, int j) -> unsigned {
+        if (i == 0)
+            return 1;
+        if (j == 0)
+            return a(i - 1, i - 1);
+        return a(i, j - 1) + a(i - 1, j - 1);
+    });
+    if (n < 0)
+        return 0;
+    // do mais pequeno para o maior, para a recursao nunca ir muito fundo
+    for (int i = 0; i < n; i++)
+        a(i, i);
+    return (int) a(n, 0);
+}
@@ -6,6 +6,7 @@
 #define PARTITIONING_H_
 
 #include "Defs.h"
+#include "BigInt.h"
 
 /*Implementa a funo s(n,k) usando recursividade*/
 int s_recursive(int n,int k);
@@ -19,4 +20,32 @@ int s_dynamic(int n,int k);
 /*Implementa a funo b(n) usando programao dinmica*/
 int b_dynamic(int n);
 
+/* Linha n completa dos numeros de Stirling de 2a especie: s(n,0), s(n,1), ..., s(n,n),
+ * calculada numa unica passagem, em precisao arbitraria. */
+vector<BigInt> s_dynamic(int n);
+
+/* A mesma linha, modulo p (p > 0), com a tabela (i,k) preenchida pelo executor em
+ * frente de onda (WavefrontDP.h) em numThreads threads (0 = numero de cores). */
+vector<unsigned> s_dynamicMod(int n, unsigned p, unsigned numThreads = 0);
+
+/* Numeros de Bell b(0), b(1), ..., b(n), em precisao arbitraria.
+ * Usa o triangulo de Bell: O(n^2) somas, guardando apenas a linha anterior. */
+vector<BigInt> bellNumbers(int n);
+
+/* O mesmo que bellNumbers, modulo p (p > 0). */
+vector<unsigned> bellNumbersMod(int n, unsigned p);
+
+/* Valores exactos de s(n,k) e b(n). Ate n = 25 sao consultas a tabela calculada
+ * em tempo de compilacao (Tables.h); acima disso usam s_dynamic(n) e bellNumbers(n). */
+BigInt stirlingBig(int n, int k);
+BigInt bellBig(int n);
+
+/* s(n,k) e b(n) pelas definicoes recursivas, com memoizacao (Memoize.h):
+ * s(n,k) num array denso para n,k < 128 (acima disso numa tabela de hash), b(n) pelo
+ * triangulo de Bell numa tabela de hash.
+ * Podem ser chamadas de varias threads ao mesmo tempo. Os resultados sao truncados a
+ * 32 bits, como nas outras versoes int. */
+int s_memoized(int n, int k);
+int b_memoized(int n);
+
 #endif /* SUM_H_ */
@@ -3,27 +3,306 @@
  */
 
 #include "Sum.h"
-#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
-string calcSum(int* sequence, int size)
+// abaixo deste tamanho nao compensa lancar threads
+static const int PARALLEL_THRESHOLD = 4096;
+// numero de valores de m que cada thread reserva de cada vez
+static const int LENGTHS_PER_TASK = 32;
+// elementos por bloco em calcSumFile (dois buffers de long long cabem na cache L2)
+static const long long STREAM_BLOCK = 16384;
+
+/* Menor valor de hi[j] - lo[j], para 0 <= j < count, e o primeiro j onde ocorre. */
+static pair<long long,int> minDiff(const long long* hi, const long long* lo, int count)
 {
-	string res;
-	for (int i = 1 ; i <= size; i++) {
-		int idx = 0;
-		int sum = -1;
-		for(int j=0; j+i< size+1; j++) {
-			int part_sum = 0;
-			for(int k = 0 ; k < i ; k++) {
-				part_sum += sequence[j + k];
-			}
-			if( sum > part_sum || sum == -1) {
-				sum = part_sum;
-				idx = j;
-			}
+	long long best = hi[0] - lo[0];
+	int idx = 0;
+	int j = 1;
+
+#ifdef __AVX2__
+	if (count >= 8) {
+		// 1a passagem: so o minimo, com dois acumuladores independentes
+		__m256i vbest0 = _mm256_set1_epi64x(LLONG_MAX);
+		__m256i vbest1 = vbest0;
+		for (j = 0; j + 8 <= count; j += 8) {
+			__m256i s0 = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*) (hi + j)),
+					_mm256_loadu_si256((const __m256i*) (lo + j)));
+			__m256i s1 = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*) (hi + j + 4)),
+					_mm256_loadu_si256((const __m256i*) (lo + j + 4)));
+			vbest0 = _mm256_blendv_epi8(vbest0, s0, _mm256_cmpgt_epi64(vbest0, s0));
+			vbest1 = _mm256_blendv_epi8(vbest1, s1, _mm256_cmpgt_epi64(vbest1, s1));
+		}
+		long long lanes[8];
+		_mm256_storeu_si256((__m256i*) lanes, vbest0);
+		_mm256_storeu_si256((__m256i*) (lanes + 4), vbest1);
+		best = *min_element(lanes, lanes + 8);
+		for (int k = j; k < count; k++)
+			best = min(best, hi[k] - lo[k]);
+
+		// 2a passagem: primeiro indice onde o minimo ocorre
+		const __m256i target = _mm256_set1_epi64x(best);
+		for (j = 0; j + 4 <= count; j += 4) {
+			__m256i s = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*) (hi + j)),
+					_mm256_loadu_si256((const __m256i*) (lo + j)));
+			int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(s, target)));
+			if (mask != 0)
+				return make_pair(best, j + __builtin_ctz(mask));
+		}
+		for (; hi[j] - lo[j] != best; j++)
+			;
+		return make_pair(best, j);
+	}
+#endif
+
+	for (; j < count; j++) {
+		long long s = hi[j] - lo[j];
+		if (s < best) {
+			best = s;
+			idx = j;
+		}
+	}
+	return make_pair(best, idx);
+}
+
+/* Escreve v em decimal a partir de out e devolve o fim do texto escrito. */
+static char* writeNumber(char* out, long long v)
+{
+	unsigned long long u = v;
+	if (v < 0) {
+		*out++ = '-';
+		u = 0ULL - u;
+	}
+	char digits[20];
+	int len = 0;
+	do {
+		digits[len++] = (char) ('0' + u % 10);
+		u /= 10;
+	} while (u != 0);
+	while (len > 0)
+		*out++ = digits[--len];
+	return out;
+}
+
+vector<pair<long long,int> > calcSumPairs(int* sequence, int size)
+{
+	if (size <= 0)
+		return vector<pair<long long,int> >();
+
+	vector<pair<long long,int> > res(size);
+	vector<long long> prefix(size + 1, 0);
+	for (int i = 0; i < size; i++)
+		prefix[i + 1] = prefix[i] + sequence[i];
+
+	atomic<int> next(1);
+	auto worker = [&]() {
+		for (;;) {
+			int first = next.fetch_add(LENGTHS_PER_TASK);
+			if (first > size)
+				break;
+			int last = min(size, first + LENGTHS_PER_TASK - 1);
+			for (int m = first; m <= last; m++)
+				res[m - 1] = minDiff(prefix.data() + m, prefix.data(), size - m + 1);
 		}
-			res += to_string(sum) + "," + to_string(idx) + ";";
+	};
 
+	unsigned numThreads = thread::hardware_concurrency();
+	if (numThreads <= 1 || size < PARALLEL_THRESHOLD) {
+		worker();
+		return res;
 	}
+
+	vector<thread> threads;
+	for (unsigned t = 1; t < numThreads; t++)
+		threads.push_back(thread(worker));
+	worker();
+	for (thread &t : threads)
+		t.join();
 	return res;
 }
 
+/* Texto "soma,indice;" de cada comprimento, no formato de calcSum. */
+static string formatSums(const vector<pair<long long,int> > &sums)
+{
+	// "soma,indice;" ocupa no maximo 20 + 1 + 10 + 1 caracteres
+	string res(sums.size() * 32, '\0');
+	char* begin = &res[0];
+	char* out = begin;
+	for (const pair<long long,int> &p : sums) {
+		out = writeNumber(out, p.first);
+		*out++ = ',';
+		out = writeNumber(out, p.second);
+		*out++ = ';';
+	}
+	res.resize(out - begin);
+	return res;
+}
+
+string calcSum(int* sequence, int size)
+{
+	return formatSums(calcSumPairs(sequence, size));
+}
+
+MinWindowSums::MinWindowSums() : prefix(1, 0)
+{
+}
+
+void MinWindowSums::append(int value)
+{
+	int n = best.size() + 1;
+	long long total = prefix.back() + value;
+	prefix.push_back(total);
+	best.push_back(make_pair(total, 0));
+
+	// a janela nova de comprimento m comeca em n - m
+	const long long* p = prefix.data();
+	for (int m = 1; m < n; m++) {
+		long long s = total - p[n - m];
+		if (s < best[m - 1].first)
+			best[m - 1] = make_pair(s, n - m);
+	}
+}
+
+int MinWindowSums::size() const
+{
+	return best.size();
+}
+
+const vector<pair<long long,int> >& MinWindowSums::pairs() const
+{
+	return best;
+}
+
+string MinWindowSums::result() const
+{
+	return formatSums(best);
+}
+
+/* Somas acumuladas P[t] (soma dos t primeiros elementos), lidas sequencialmente. */
+class PrefixStream {
+	const int* data;
+	long long size;
+	long long pos;   // proximo t a ler
+	long long sum;   // P[pos]
+public:
+	PrefixStream(const int* data, long long size) : data(data), size(size), pos(0), sum(0) {}
+
+	/* Escreve P[from..to) em out. from nao pode ser inferior ao fim da leitura anterior. */
+	void read(long long from, long long to, long long* out) {
+		for (; pos < from; pos++)
+			sum += data[pos];
+		for (; pos < to; pos++) {
+			*out++ = sum;
+			if (pos < size)
+				sum += data[pos];
+		}
+	}
+};
+
+/* Processa um grupo de comprimentos (ordenados, com max - min <= STREAM_BLOCK).
+ * Para cada m, as somas sao P[t] - P[t-m] com m <= t <= n; os P[t] vem de um stream
+ * e os P[t-m] de outro, que segue atras dele. */
+static void scanGroup(const int* data, long long n, const vector<long long> &lengths,
+		vector<pair<long long,long long> > &best)
+{
+	long long mlo = lengths.front(), mhi = lengths.back();
+	PrefixStream hiStream(data, n), loStream(data, n);
+	vector<long long> hiBuf(STREAM_BLOCK), loBuf(STREAM_BLOCK + mhi - mlo);
+	long long loStart = 0, loEnd = 0;   // loBuf tem P[loStart..loEnd)
+
+	for (long long block = mlo; block <= n; block += STREAM_BLOCK) {
+		long long blockEnd = min(block + STREAM_BLOCK, n + 1);
+		hiStream.read(block, blockEnd, hiBuf.data());
+
+		long long newStart = max(0LL, block - mhi);
+		long long newEnd = blockEnd - mlo;
+		if (newStart < loEnd) {
+			memmove(loBuf.data(), loBuf.data() + (newStart - loStart), (loEnd - newStart) * sizeof(long long));
+			loStream.read(loEnd, newEnd, loBuf.data() + (loEnd - newStart));
+		}
+		else
+			loStream.read(newStart, newEnd, loBuf.data());
+		loStart = newStart;
+		loEnd = newEnd;
+
+		for (size_t k = 0; k < lengths.size(); k++) {
+			long long m = lengths[k];
+			long long first = max(block, m);
+			if (first >= blockEnd)
+				continue;
+			pair<long long,int> r = minDiff(hiBuf.data() + (first - block),
+					loBuf.data() + (first - m - loStart), (int) (blockEnd - first));
+			if (best[k].second < 0 || r.first < best[k].first)
+				best[k] = make_pair(r.first, first - m + r.second);
+		}
+	}
+}
+
+vector<pair<long long,long long> > calcSumFile(const string &path, const vector<long long> &windowLengths)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw runtime_error("calcSumFile: cannot open " + path);
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw runtime_error("calcSumFile: cannot stat " + path);
+	}
+	long long n = st.st_size / (long long) sizeof(int);
+
+	const int* data = NULL;
+	void* mapped = MAP_FAILED;
+	if (n > 0) {
+		mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close(fd);
+			throw runtime_error("calcSumFile: cannot map " + path);
+		}
+		madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+		data = (const int*) mapped;
+	}
+	close(fd);
+
+	vector<pair<long long,long long> > res(windowLengths.size(), make_pair(0LL, -1LL));
+
+	// comprimentos validos, por ordem crescente, com a posicao onde vao na resposta
+	vector<pair<long long,size_t> > order;
+	for (size_t i = 0; i < windowLengths.size(); i++)
+		if (windowLengths[i] > 0 && windowLengths[i] <= n)
+			order.push_back(make_pair(windowLengths[i], i));
+	sort(order.begin(), order.end());
+
+	size_t i = 0;
+	while (i < order.size()) {
+		size_t j = i;
+		vector<long long> lengths;
+		while (j < order.size() && order[j].first - order[i].first <= STREAM_BLOCK) {
+			if (lengths.empty() || lengths.back() != order[j].first)
+				lengths.push_back(order[j].first);
+			j++;
+		}
+		vector<pair<long long,long long> > best(lengths.size(), make_pair(0LL, -1LL));
+		scanGroup(data, n, lengths, best);
+		for (size_t k = i, l = 0; k < j; k++) {
+			while (lengths[l] != order[k].first)
+				l++;
+			res[order[k].second] = best[l];
+		}
+		i = j;
+	}
+
+	if (mapped != MAP_FAILED)
+		munmap(mapped, st.st_size);
+	return res;
+}
@@ -21,4 +21,48 @@
  */
 string calcSum(int* sequence, int size);
 
+/* Mesmo calculo que calcSum, mas devolve, para cada m (de 1 a size), o par
+ * (soma minima, indice i) em vez da string.
+ *
+ * As somas sao obtidas a partir das somas acumuladas (calculadas uma unica vez),
+ * pelo que cada m custa O(n). Os varios m sao distribuidos por threads.
+ */
+vector<pair<long long,int> > calcSumPairs(int* sequence, int size);
+
+/* Versao de calcSumPairs para sequencias demasiado grandes para memoria.
+ * A sequencia e lida (via mmap) de um ficheiro binario com inteiros de 32 bits,
+ * na ordem de bytes da maquina e sem cabecalho.
+ *
+ * So sao calculados os comprimentos m pedidos em windowLengths. Devolve, pela mesma
+ * ordem, o par (soma minima, indice); se m <= 0 ou m for maior que a sequencia,
+ * o indice devolvido e -1. As somas sao de 64 bits.
+ *
+ * Os comprimentos sao tratados em grupos de valores proximos: cada grupo percorre o
+ * ficheiro uma vez, em blocos que cabem na cache.
+ *
+ * Lanca runtime_error se o ficheiro nao puder ser lido.
+ */
+vector<pair<long long,long long> > calcSumFile(const string &path, const vector<long long> &windowLengths);
+
+/* Versao incremental de calcSum, para sequencias que vao crescendo.
+ *
+ * append(x) junta x ao fim da sequencia e actualiza, para cada comprimento m, o minimo
+ * com a unica janela nova (a que termina em x): P[n] - P[n-m], a partir das somas
+ * acumuladas. Custa O(1) por comprimento; o comprimento m = n e criado nesse momento.
+ * Em caso de empate fica o primeiro indice, como em calcSum.
+ *
+ * result() devolve a mesma string que calcSum sobre a sequencia actual, e pairs() os
+ * mesmos pares que calcSumPairs.
+ */
+class MinWindowSums {
+	vector<long long> prefix;             // prefix[t] = soma dos t primeiros elementos
+	vector<pair<long long,int> > best;    // best[m-1] = (soma minima, indice) para o comprimento m
+public:
+	MinWindowSums();
+	void append(int value);
+	int size() const;
+	const vector<pair<long long,int> >& pairs() const;
+	string result() const;
+};
+
 #endif /* SUM_H_ */
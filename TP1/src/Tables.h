@@ -0,0 +1,51 @@
+/*
+ * Tables.h
+ */
+
+#ifndef TABLES_H_
+#define TABLES_H_
+
+/* Tabelas de factoriais, numeros de Stirling de 2a especie e numeros de Bell,
+ * calculadas em tempo de compilacao para todos os valores que cabem em 64 bits.
+ */
+
+/* Maior n com n! < 2^64 */
+const int FACTORIAL_TABLE_MAX = 20;
+
+/* Maior n com b(n) < 2^64 (logo tambem s(n,k) < 2^64 para todo o k) */
+const int PARTITION_TABLE_MAX = 25;
+
+struct FactorialTable {
+	unsigned long long value[FACTORIAL_TABLE_MAX + 1];
+
+	constexpr FactorialTable() : value() {
+		value[0] = 1;
+		for (int n = 1; n <= FACTORIAL_TABLE_MAX; n++)
+			value[n] = value[n - 1] * n;
+	}
+};
+
+/* stirling[n][k] = s(n,k); bell[n] = b(n) = s(n,0) + ... + s(n,n) */
+struct PartitionTable {
+	unsigned long long stirling[PARTITION_TABLE_MAX + 1][PARTITION_TABLE_MAX + 1];
+	unsigned long long bell[PARTITION_TABLE_MAX + 1];
+
+	constexpr PartitionTable() : stirling(), bell() {
+		stirling[0][0] = 1;
+		for (int n = 1; n <= PARTITION_TABLE_MAX; n++)
+			for (int k = 1; k <= n; k++)
+				stirling[n][k] = k * stirling[n - 1][k] + stirling[n - 1][k - 1];
+		for (int n = 0; n <= PARTITION_TABLE_MAX; n++)
+			for (int k = 0; k <= n; k++)
+				bell[n] += stirling[n][k];
+	}
+};
+
+static constexpr FactorialTable factorialTable;
+static constexpr PartitionTable partitionTable;
+
+static_assert(factorialTable.value[FACTORIAL_TABLE_MAX] == 2432902008176640000ULL, "20!");
+static_assert(partitionTable.stirling[10][6] == 22827, "s(10,6)");
+static_assert(partitionTable.bell[PARTITION_TABLE_MAX] == 4638590332229999353ULL, "b(25)");
+
+#endif /* TABLES_H_ */
@@ -3,6 +3,12 @@
 #include "Change.h"
 #include "Sum.h"
 #include "Partitioning.h"
+#include "BigInt.h"
+#include "ThreadPool.h"
+#include "Memoize.h"
+#include "WavefrontDP.h"
+#include "Tables.h"
+#include <climits>
 
 #include "cute/cute.h"
 #include "cute/ide_listener.h"
@@ -17,6 +23,61 @@ void factorialTest()
         ASSERT_EQUAL(3628800,factorialDinam(10));
 }
 
+void bigFactorialTest()
+{
+	BigInt product(1);
+	for (int i = 2; i <= 3000; i++)
+		product *= i;
+	ASSERT_EQUAL(product, factorialBig(3000));
+	ASSERT_EQUAL(product, factorialBig(3000, 3));
+	// acima do limiar usa o pool; tem de dar o mesmo que a arvore sequencial
+	ASSERT_EQUAL(factorialBig(6000, 1), factorialBig(6000, 3));
+
+	string f1000 = factorialBig(1000).toString();
+	ASSERT_EQUAL(2568u, f1000.size());
+	ASSERT_EQUAL("402387260077093773543702433923", f1000.substr(0, 30));
+
+	// Karatsuba (sequencial e no pool) contra a multiplicacao por numeros pequenos
+	BigInt a = factorialBig(4000), b(1);
+	for (int i = 0; i < 2000; i++)
+		b *= 4000000007u;
+	BigInt expected = a;
+	for (int i = 0; i < 2000; i++)
+		expected *= 4000000007u;
+	ThreadPool pool(4);
+	ASSERT_EQUAL(expected, a * b);
+	ASSERT_EQUAL(expected, BigInt::multiply(a, b, pool));
+
+	ASSERT_EQUAL(1, factorialDigits(0));
+	ASSERT_EQUAL(19, factorialDigits(20));
+	ASSERT_EQUAL(2568, factorialDigits(1000));
+	ASSERT_EQUAL(5565709, factorialDigits(1000000));
+	ASSERT_EQUAL(factorialDigits(30000), (long long) factorialBig(30000).toString().size());
+}
+
+void combinatoricsTablesTest()
+{
+	ASSERT_EQUAL(1, factorialRecurs(0));
+	ASSERT_EQUAL(479001600, factorialDinam(12));
+	ASSERT_EQUAL(BigInt(2432902008176640000ULL), factorialBig(20));
+	ASSERT_EQUAL("15511210043330985984000000", factorialBig(25).toString());
+	ASSERT_EQUAL("265252859812191058636308480000000", factorialBig(30).toString());
+
+	ASSERT_EQUAL(BigInt(362262620784874680ULL), stirlingBig(25, 12));
+	ASSERT_EQUAL("12879868072770626040000", stirlingBig(30, 15).toString());
+	ASSERT_EQUAL("162188909527975750487887236507181", stirlingBig(40, 20).toString());
+	ASSERT_EQUAL(BigInt(0), stirlingBig(5, 6));
+	ASSERT_EQUAL(BigInt(4638590332229999353ULL), bellBig(25));
+	ASSERT_EQUAL(bellNumbers(26)[26], bellBig(26));
+
+	// antes exponencial; agora consultas a tabela (com o mesmo resultado truncado a int)
+	ASSERT_EQUAL((int) 362262620784874680ULL, s_recursive(25, 12));
+	ASSERT_EQUAL((int) 4638590332229999353ULL, b_recursive(25));
+	// b(0) continua a ser 0, como nas versoes originais (a soma de s(0,k) para k >= 1)
+	ASSERT_EQUAL(0, b_recursive(0));
+	ASSERT_EQUAL(0, b_dynamic(0));
+}
+
 void calcChangeTest()
 {
 	int numCoins = 3;
@@ -38,6 +99,175 @@ void calcChangeTest()
 
 }
 
+void changeMakerTest()
+{
+	int coinValues[] = {1, 4, 5};
+	ChangeMaker maker(3, coinValues);
+	ASSERT_EQUAL("4;4;", maker.change(8));
+	ASSERT_EQUAL("", maker.change(0));
+	ASSERT_EQUAL("5;4;4;", maker.change(13));
+
+	vector<string> batch = maker.change(vector<int>{16, 3, 2000000});
+	ASSERT_EQUAL(3u, batch.size());
+	ASSERT_EQUAL("5;5;5;1;", batch[0]);
+	ASSERT_EQUAL("1;1;1;", batch[1]);
+	ASSERT_EQUAL(400000 * 2, (int) batch[2].size());
+	ASSERT(maker.tableSize() <= maker.stats().periodBound);
+
+	int coinValues2[] = {2, 5};
+	ChangeMaker maker2(2, coinValues2);
+	ASSERT_EQUAL("-", maker2.change(1));
+	ASSERT_EQUAL("-", maker2.change(3));
+	ASSERT_EQUAL("5;2;", maker2.change(7));
+	ASSERT_EQUAL("2;2;2;", maker2.change(6));
+}
+
+void changeMakerLargeAmountsTest()
+{
+	int coinValues[] = {1, 4, 5};
+	ChangeMaker maker(3, coinValues);
+	ASSERT_EQUAL(16, maker.stats().periodBound);
+	ASSERT_EQUAL("5x199999999;4x3;", maker.changeCompressed(1000000007));
+	ASSERT_EQUAL("5x3689348814741910323;", maker.changeCompressed(18446744073709551615ULL));
+	ASSERT_EQUAL("4x2;", maker.changeCompressed(8));
+	ASSERT_EQUAL("", maker.changeCompressed(0));
+	ASSERT_EQUAL(16, maker.stats().tableSize);
+
+	// moedas grandes: (cmax - 1) * c2 nao cabe num int
+	int bigCanonical[] = {1, 100000, 200000};
+	ChangeMaker canonical(3, bigCanonical);
+	ASSERT_EQUAL(INT_MAX, canonical.stats().periodBound);
+	ASSERT_EQUAL("200000;200000;1;", canonical.change(400001));
+	int bigOdd[] = {1, 50000, 60000};
+	ASSERT_EQUAL("1;1;1;1;1;", calcChange(5, 3, bigOdd));
+	ChangeMaker odd(3, bigOdd);
+	ASSERT_EQUAL(INT_MAX, odd.stats().periodBound);
+	ASSERT_EQUAL("60000;1;", odd.change(60001));
+	ASSERT_EQUAL("50000;50000;", odd.change(100000));
+	ASSERT_EQUAL("50000x2;", odd.changeCompressed(100000));
+	ASSERT_THROWS(odd.changeCompressed(3000000000ULL), out_of_range);
+
+	// lastCoin tem 16 bits: mais de 65535 moedas diferentes e rejeitado, em vez de truncado
+	vector<int> many(70000);
+	for (int i = 0; i < 70000; i++)
+		many[i] = i + 1;
+	ASSERT_THROWS(ChangeMaker(70000, many.data()), invalid_argument);
+
+	vector<pair<int,unsigned long long> > counts;
+	ASSERT_EQUAL(true, maker.changeCounts(1000000000000ULL + 3, counts));
+	ASSERT_EQUAL(2u, counts.size());
+	ASSERT_EQUAL(5, counts[0].first);
+	ASSERT_EQUAL(199999999999ULL, counts[0].second);
+	ASSERT_EQUAL(4, counts[1].first);
+	ASSERT_EQUAL(2ULL, counts[1].second);
+
+	int coinValues2[] = {4, 6};
+	ChangeMaker maker2(2, coinValues2);
+	ASSERT_EQUAL("-", maker2.changeCompressed(1000000001));
+	ASSERT_EQUAL("6x166666666;4x1;", maker2.changeCompressed(1000000000));
+
+	int euro[] = {1, 2, 5, 10, 20, 50, 100, 200};
+	ChangeMaker maker3(8, euro);
+	ASSERT_EQUAL("200x5000000000;5x1;2x1;", maker3.changeCompressed(1000000000007ULL));
+}
+
+void boundedChangeTest()
+{
+	int coinValues[] = {1, 2, 5};
+	int coinCounts[] = {1, 3, 1};
+	ASSERT_EQUAL("5;2;2;", calcChangeBounded(9, 3, coinValues, coinCounts));
+	ASSERT_EQUAL("5;2;2;2;1;", calcChangeBounded(12, 3, coinValues, coinCounts));
+	ASSERT_EQUAL("-", calcChangeBounded(13, 3, coinValues, coinCounts));
+
+	BoundedChangeMaker maker(3, coinValues, coinCounts);
+	ASSERT_EQUAL("5;2;", maker.dispense(7));
+	ASSERT_EQUAL(0, maker.getStock(5));
+	ASSERT_EQUAL(2, maker.getStock(2));
+	ASSERT_EQUAL("2;2;1;", maker.change(5));
+	ASSERT_EQUAL("-", maker.change(6));
+	maker.addStock(5, 10);
+	ASSERT_EQUAL("5;5;5;2;1;", maker.change(18));
+	ASSERT_EQUAL(1, maker.getStock(1));
+
+	// stock grande: o custo nao depende das quantidades
+	int coinValues2[] = {1, 4, 5};
+	int coinCounts2[] = {1000000, 1000000, 2};
+	BoundedChangeMaker maker2(3, coinValues2, coinCounts2);
+	ASSERT_EQUAL("5;5;4;4;", maker2.change(18));
+	string big = maker2.change(400010);
+	ASSERT_EQUAL(string("5;5;") + "4;4;", big.substr(0, 8));
+	ASSERT_EQUAL((2 + 100000) * 2, (int) big.size());
+
+	// uma moeda que comeca sem stock pode ser reposta e entregue
+	int coinValues3[] = {1, 10, 3};
+	int coinCounts3[] = {5, 0, 0};
+	BoundedChangeMaker maker3(3, coinValues3, coinCounts3);
+	ASSERT_EQUAL(0, maker3.getStock(10));
+	ASSERT_EQUAL("-", maker3.change(10));
+	ASSERT_EQUAL("1;1;1;", maker3.change(3));
+	maker3.addStock(10, 2);
+	maker3.addStock(3, 1);
+	ASSERT_EQUAL(2, maker3.getStock(10));
+	ASSERT_EQUAL("10;3;", maker3.dispense(13));
+	ASSERT_EQUAL(1, maker3.getStock(10));
+	ASSERT_EQUAL(0, maker3.getStock(3));
+	ASSERT_EQUAL("10;1;1;1;", maker3.dispense(13));
+	ASSERT_EQUAL("-", maker3.change(10));
+}
+
+void countChangeTest()
+{
+	int coinValues[] = {1, 2, 5};
+	ASSERT_EQUAL(4u, countChange(5, 3, coinValues, 1000000007));
+	ASSERT_EQUAL(1u, countChange(0, 3, coinValues, 1000000007));
+
+	int uk[] = {1, 2, 5, 10, 20, 50, 100, 200};
+	ASSERT_EQUAL(73682u, countChange(200, 8, uk, 1000000007));
+	ASSERT_EQUAL(73682u % 101, countChange(200, 8, uk, 101));
+
+	vector<vector<int> > systems = {{1, 2, 5}, {2, 5}, {1, 2, 5, 10, 20, 50, 100, 200}, {3, 7, 40}};
+	vector<unsigned> res = countChange(200, systems, 1000000007);
+	ASSERT_EQUAL(4u, res.size());
+	ASSERT_EQUAL(73682u, res[2]);
+	for (size_t s = 0; s < systems.size(); s++)
+		ASSERT_EQUAL(countChange(200, systems[s].size(), systems[s].data(), 1000000007), res[s]);
+
+	// 1 + 2 + ... : formas de obter m com {1, 2} = m/2 + 1
+	int coinValues2[] = {1, 2};
+	ASSERT_EQUAL(5000001u, countChange(10000000, 2, coinValues2, 1000000007));
+}
+
+void changeMakerCanonicalTest()
+{
+	int euro[] = {1, 2, 5, 10, 20, 50, 100, 200};
+	ChangeMaker maker(8, euro);
+	ASSERT_EQUAL("200;50;20;5;2;2;", maker.change(279));
+	ASSERT_EQUAL("", maker.change(0));
+	ChangeStats s = maker.stats();
+	ASSERT_EQUAL(CHANGE_GREEDY, s.path);
+	ASSERT_EQUAL(true, s.canonical);
+	ASSERT_EQUAL(-1, s.counterexample);
+	ASSERT_EQUAL(0, s.tableSize);
+	ASSERT_EQUAL(2, s.queries);
+
+	int coinValues[] = {1, 4, 5};
+	ChangeMaker maker2(3, coinValues);
+	ASSERT_EQUAL("4;4;", maker2.change(8));
+	s = maker2.stats();
+	ASSERT_EQUAL(CHANGE_TABLE, s.path);
+	ASSERT_EQUAL(false, s.canonical);
+	ASSERT_EQUAL(8, s.counterexample);
+
+	int coinValues2[] = {1, 3, 4, 11};
+	ASSERT_EQUAL(6, ChangeMaker(4, coinValues2).stats().counterexample);
+
+	// sem moeda 1 o ganancioso pode falhar: fica a tabela
+	int coinValues3[] = {2, 5};
+	ChangeMaker maker3(2, coinValues3);
+	ASSERT_EQUAL(CHANGE_TABLE, maker3.stats().path);
+	ASSERT_EQUAL("2;2;2;", maker3.change(6));
+}
+
 
 void calcSumArrayTest()
 {
@@ -48,6 +278,108 @@ void calcSumArrayTest()
 	ASSERT_EQUAL("1,1;5,3;11,3;16,1;20,3;24,3;31,1;35,1;41,0;",calcSum(sequence2, 9));
 }
 
+void calcSumPairsTest()
+{
+	int sequence[5] = {4,7,2,8,1};
+	vector<pair<long long,int> > res = calcSumPairs(sequence, 5);
+	ASSERT_EQUAL(5u, res.size());
+	ASSERT_EQUAL(1, res[0].first);
+	ASSERT_EQUAL(4, res[0].second);
+	ASSERT_EQUAL(22, res[4].first);
+	ASSERT_EQUAL(0, res[4].second);
+
+	// valores negativos e somas que nao cabem num int
+	int sequence2[6] = {2000000000, -5, 2000000000, -5, -5, 2000000000};
+	ASSERT_EQUAL("-5,1;-10,3;1999999990,1;1999999985,1;3999999985,0;5999999985,0;",calcSum(sequence2, 6));
+
+	// comparar com o calculo directo (inclui o caminho vectorizado e varias threads)
+	int size = 5000;
+	vector<int> seq(size);
+	unsigned seed = 12345;
+	for (int i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		seq[i] = (int) ((seed >> 16) % 2001) - 1000;
+	}
+	res = calcSumPairs(seq.data(), size);
+	for (int m = 1; m <= size; m += 499) {
+		long long window = 0;
+		for (int k = 0; k < m; k++)
+			window += seq[k];
+		long long best = window;
+		int idx = 0;
+		for (int j = 1; j + m <= size; j++) {
+			window += seq[j + m - 1] - seq[j - 1];
+			if (window < best) {
+				best = window;
+				idx = j;
+			}
+		}
+		ASSERT_EQUAL(best, res[m - 1].first);
+		ASSERT_EQUAL(idx, res[m - 1].second);
+	}
+}
+
+void calcSumFileTest()
+{
+	int size = 50000;
+	vector<int> seq(size);
+	unsigned seed = 777;
+	for (int i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		seq[i] = (int) ((seed >> 8) % 2000001) - 1000000;
+	}
+	const char* path = "calcSumFileTest.bin";
+	FILE* f = fopen(path, "wb");
+	ASSERTM("cannot create the temporary file", f != NULL);
+	fwrite(seq.data(), sizeof(int), size, f);
+	fclose(f);
+
+	vector<long long> lengths = {50000, 1, 16390, 7, 20000, 60000, 20001, 0, 49999, 7};
+	vector<pair<long long,long long> > res = calcSumFile(path, lengths);
+	remove(path);
+
+	vector<pair<long long,int> > expected = calcSumPairs(seq.data(), size);
+	ASSERT_EQUAL(lengths.size(), res.size());
+	for (size_t i = 0; i < lengths.size(); i++) {
+		if (lengths[i] < 1 || lengths[i] > size) {
+			ASSERT_EQUAL(-1, res[i].second);
+			continue;
+		}
+		ASSERT_EQUAL(expected[lengths[i] - 1].first, res[i].first);
+		ASSERT_EQUAL(expected[lengths[i] - 1].second, res[i].second);
+	}
+}
+
+void minWindowSumsTest()
+{
+	int sequence[5] = {4,7,2,8,1};
+	MinWindowSums sums;
+	ASSERT_EQUAL("", sums.result());
+	for (int i = 0; i < 5; i++) {
+		sums.append(sequence[i]);
+		ASSERT_EQUAL(calcSum(sequence, i + 1), sums.result());
+	}
+	ASSERT_EQUAL(5, sums.size());
+
+	// empates ficam com o primeiro indice; somas de 64 bits
+	int sequence2[8] = {3, -1, 3, -1, 2000000000, 2000000000, -5, -5};
+	MinWindowSums sums2;
+	for (int i = 0; i < 8; i++) {
+		sums2.append(sequence2[i]);
+		ASSERT_EQUAL(calcSumPairs(sequence2, i + 1), sums2.pairs());
+	}
+
+	vector<int> seq(3000);
+	unsigned seed = 777;
+	MinWindowSums sums3;
+	for (int &x : seq) {
+		seed = seed * 1103515245 + 12345;
+		x = (int) ((seed >> 16) % 201) - 100;
+		sums3.append(x);
+	}
+	ASSERT_EQUAL(calcSum(seq.data(), seq.size()), sums3.result());
+}
+
 void partitioningTest()
 {
 	ASSERT_EQUAL(3025,s_recursive(9,3));
@@ -62,13 +394,157 @@ void partitioningTest()
 	ASSERT_EQUAL(1382958545,b_dynamic(15));
 }
 
+void memoizeTest()
+{
+	ASSERT_EQUAL(3025, s_memoized(9, 3));
+	ASSERT_EQUAL(22827, s_memoized(10, 6));
+	ASSERT_EQUAL(1382958545, b_memoized(15));
+	ASSERT_EQUAL(1, b_memoized(0));
+	ASSERT_EQUAL((int) partitionTable.stirling[25][12], s_memoized(25, 12));
+	ASSERT_EQUAL((int) partitionTable.bell[25], b_memoized(25));
+	ASSERT_EQUAL((int) stirlingBig(120, 40).low64(), s_memoized(120, 40));
+	ASSERT_EQUAL((int) bellBig(200).low64(), b_memoized(200));
+
+	// varias threads sobre o mesmo memoize
+	typedef memoize<unsigned long long(int)> FibMemo;
+	FibMemo fib([](FibMemo &fib, int n) -> unsigned long long {
+		return n < 2 ? n : fib(n - 1) + fib(n - 2);
+	});
+	vector<thread> threads;
+	vector<unsigned long long> results(8);
+	vector<int> stirling(8);
+	for (int t = 0; t < 8; t++)
+		threads.push_back(thread([&, t] {
+			results[t] = fib(90 - t);
+			stirling[t] = s_memoized(100 + t, 50);
+		}));
+	for (thread &t : threads)
+		t.join();
+	ASSERT_EQUAL(2880067194370816120ULL, results[0]);
+	ASSERT_EQUAL(91u, fib.size());
+	for (int t = 0; t < 8; t++)
+		ASSERT_EQUAL((int) stirlingBig(100 + t, 50).low64(), stirling[t]);
+
+	typedef memoize<int(int,int), DenseBounds<10,10> > GridMemo;
+	int calls = 0;
+	GridMemo paths([&calls](GridMemo &paths, int x, int y) {
+		calls++;
+		return x == 0 || y == 0 ? 1 : paths(x - 1, y) + paths(x, y - 1);
+	});
+	ASSERT_EQUAL(48620, paths(9, 9));
+	ASSERT_EQUAL(99, calls);   // cada (x,y) alcancado uma unica vez; (0,0) nunca e pedido
+	ASSERT_EQUAL(184756, paths(10, 10));   // fora dos limites: guardado na tabela de hash
+	ASSERT_EQUAL(120, calls);              // mais (10,0..10) e (0..9,10), uma vez cada
+	ASSERT_EQUAL(184756, paths(10, 10));
+	ASSERT_EQUAL(120, calls);
+
+	// acima do array denso (128) a recursao continua memoizada, nao exponencial
+	ASSERT_EQUAL((int) stirlingBig(200, 100).low64(), s_memoized(200, 100));
+	ASSERT_EQUAL((int) stirlingBig(300, 150).low64(), s_memoized(300, 150));
+}
+
+void bellNumbersTest()
+{
+	vector<BigInt> row = s_dynamic(10);
+	ASSERT_EQUAL(11u, row.size());
+	ASSERT_EQUAL(BigInt(0), row[0]);
+	ASSERT_EQUAL(BigInt(1), row[1]);
+	ASSERT_EQUAL(BigInt(22827), row[6]);
+	ASSERT_EQUAL(BigInt(1), row[10]);
+
+	vector<BigInt> bell = bellNumbers(100);
+	ASSERT_EQUAL(BigInt(1), bell[0]);
+	ASSERT_EQUAL(BigInt(203), bell[6]);
+	ASSERT_EQUAL("846749014511809332450147", bell[30].toString());
+	ASSERT_EQUAL("4758539127676483365879076884138720782636366968682561146661633463755911449789244262267"
+			"2724044217756306953557882560751", bell[100].toString());
+
+	// b(n) = soma da linha n de Stirling
+	BigInt sum;
+	for (const BigInt &s : s_dynamic(100))
+		sum += s;
+	ASSERT_EQUAL(bell[100], sum);
+
+	vector<unsigned> bellMod = bellNumbersMod(1000, 1000000007);
+	ASSERT_EQUAL(1001u, bellMod.size());
+	ASSERT_EQUAL(465231251u, bellMod[1000]);
+	ASSERT_EQUAL(bell[100].mod(1000000007), bellMod[100]);
+	ASSERT_EQUAL(1928u, bellNumbers(1000)[1000].toString().size());
+}
+
+
+void wavefrontTest()
+{
+	// caminhos numa grelha: f(i,j) = f(i-1,j) + f(i,j-1) + f(i,j-3) + f(i-1,j-1), comparado
+	// com a tabela completa, para varios tamanhos de bloco e de pool
+	const unsigned p = 1000003;
+	const int rows = 37, cols = 101;
+	vector<vector<unsigned> > full(rows, vector<unsigned>(cols));
+	for (int i = 0; i < rows; i++)
+		for (int j = 0; j < cols; j++) {
+			unsigned long long v = i == 0 && j == 0 ? 1 : 0;
+			if (i > 0) v += full[i - 1][j];
+			if (j > 0) v += full[i][j - 1];
+			if (j > 2) v += full[i][j - 3];
+			if (i > 0 && j > 0) v += full[i - 1][j - 1];
+			full[i][j] = v % p;
+		}
+	auto paths = [p](int i, int j, const unsigned &up, const unsigned &diag,
+			const WavefrontRow<unsigned> &left) {
+		if (i == 0 && j == 0)
+			return 1u;
+		return (unsigned) (((unsigned long long) up + diag + left(1) + left(3)) % p);
+	};
+	int tileSizes[][2] = { {1, 1}, {2, 2}, {5, 7}, {64, 256}, {3, 200} };
+	for (auto &t : tileSizes)
+		for (unsigned threads : {1u, 4u})
+			ASSERT_EQUAL(full[rows - 1], wavefront(rows, cols, paths, 0u, 3, t[0], t[1], threads));
+
+	// linha de Stirling modulo p
+	vector<BigInt> row = s_dynamic(300);
+	vector<unsigned> rowMod = s_dynamicMod(300, 1000000007);
+	ASSERT_EQUAL(301u, rowMod.size());
+	for (int k = 0; k <= 300; k++)
+		ASSERT_EQUAL(row[k].mod(1000000007), rowMod[k]);
+	ASSERT_EQUAL(vector<unsigned>(1, 1), s_dynamicMod(0, 7));
+
+	// troco pela tabela completa: mesma resposta que calcChange
+	int euro[] = {1, 2, 5, 10, 20, 50, 100, 200};
+	ASSERT_EQUAL(calcChange(279, 8, euro), calcChangeParallel(279, 8, euro));
+	int noOne[] = {3, 7};
+	ASSERT_EQUAL("-", calcChangeParallel(11, 2, noOne));
+	ASSERT_EQUAL("7;7;", calcChangeParallel(14, 2, noOne));
+	ASSERT_EQUAL("", calcChangeParallel(0, 2, noOne));
+	srand(37);
+	for (int t = 0; t < 30; t++) {
+		int coins[5];
+		for (int i = 0; i < 5; i++)
+			coins[i] = 1 + rand() % 60;
+		sort(coins, coins + 5);
+		int m = rand() % 20000;
+		ASSERT_EQUAL(calcChange(m, 5, coins), calcChangeParallel(m, 5, coins, 1 + t % 4));
+	}
+}
 
 bool runAllTests(int argc, char const *argv[]) {
 	cute::suite s { };
     s.push_back(CUTE(factorialTest));
+    s.push_back(CUTE(combinatoricsTablesTest));
+    s.push_back(CUTE(bigFactorialTest));
     s.push_back(CUTE(calcChangeTest));
+    s.push_back(CUTE(changeMakerTest));
+    s.push_back(CUTE(changeMakerLargeAmountsTest));
+    s.push_back(CUTE(changeMakerCanonicalTest));
+    s.push_back(CUTE(boundedChangeTest));
+    s.push_back(CUTE(countChangeTest));
     s.push_back(CUTE(calcSumArrayTest));
+    s.push_back(CUTE(calcSumPairsTest));
+    s.push_back(CUTE(calcSumFileTest));
+    s.push_back(CUTE(minWindowSumsTest));
     s.push_back(CUTE(partitioningTest));
+    s.push_back(CUTE(bellNumbersTest));
+    s.push_back(CUTE(memoizeTest));
+    s.push_back(CUTE(wavefrontTest));
 	cute::xml_file_opener xmlfile(argc, argv);
 	cute::xml_listener<cute::ide_listener<>> lis(xmlfile.out);
 	auto runner = cute::makeRunner(lis, argc, argv);
@@ -0,0 +1,99 @@
+/*
+ * ThreadPool.h
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+/* Conjunto fixo de threads que executam tarefas submetidas por ordem de chegada.
+ * As tarefas nao devem ficar a espera de outras tarefas do mesmo pool
+ * (com todas as threads ocupadas a esperar, ninguem as executaria).
+ */
+class ThreadPool {
+	vector<thread> workers;
+	queue<function<void()> > tasks;
+	mutex lock;
+	condition_variable available;
+	bool stopping;
+
+	void run();
+public:
+	/* numThreads = 0 usa o numero de cores da maquina. */
+	ThreadPool(unsigned numThreads = 0);
+	~ThreadPool();
+
+	unsigned size() const;
+
+	/* Agenda f() e devolve o future do seu resultado. */
+	template <class F>
+	future<typename result_of<F()>::type> submit(F f);
+};
+
+inline ThreadPool::ThreadPool(unsigned numThreads) : stopping(false)
+{
+	if (numThreads == 0)
+		numThreads = thread::hardware_concurrency();
+	if (numThreads == 0)
+		numThreads = 1;
+	for (unsigned i = 0; i < numThreads; i++)
+		workers.push_back(thread(&ThreadPool::run, this));
+}
+
+inline ThreadPool::~ThreadPool()
+{
+	{
+		unique_lock<mutex> guard(lock);
+		stopping = true;
+	}
+	available.notify_all();
+	for (thread &t : workers)
+		t.join();
+}
+
+inline unsigned ThreadPool::size() const
+{
+	return workers.size();
+}
+
+inline void ThreadPool::run()
+{
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock<mutex> guard(lock);
+			available.wait(guard, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty())
+				return;
+			task = move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
+
+template <class F>
+future<typename result_of<F()>::type> ThreadPool::submit(F f)
+{
+	typedef typename result_of<F()>::type R;
+	shared_ptr<packaged_task<R()> > task = make_shared<packaged_task<R()> >(move(f));
+	future<R> res = task->get_future();
+	{
+		unique_lock<mutex> guard(lock);
+		tasks.push([task] { (*task)(); });
+	}
+	available.notify_one();
+	return res;
+}
+
+#endif /* THREADPOOL_H_ */
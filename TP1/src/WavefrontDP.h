@@ -0,0 +1,101 @@
+/*
+ * WavefrontDP.h
+ */
+
+#ifndef WAVEFRONTDP_H_
+#define WAVEFRONTDP_H_
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+using namespace std;
+
+/* Acesso, dentro da recorrencia, as celulas a esquerda na mesma linha:
+ * left(d) e a celula (i, j-d), para 1 <= d <= reach (fora da tabela: o valor "outside"). */
+template <class T>
+class WavefrontRow {
+	const T *cell;
+public:
+	explicit WavefrontRow(const T *cell) : cell(cell) {}
+	const T& operator()(int d) const { return cell[-d]; }
+};
+
+/* Executa uma programacao dinamica 2-D em que a celula (i,j) depende de (i-1,j),
+ * (i-1,j-1) e de (i,j-d) com d <= reach, e devolve a ultima linha (rows-1).
+ *
+ *   T recurrence(int i, int j, const T &up, const T &diag, const WavefrontRow<T> &left)
+ *
+ * Celulas fora da tabela (i < 0 ou j < 0) valem outside.
+ *
+ * A tabela e dividida em blocos de tileRows x tileCols; os blocos de cada anti-diagonal
+ * sao independentes e correm em paralelo num ThreadPool de numThreads threads
+ * (0 = numero de cores). Nao se guarda a tabela inteira: apenas a ultima linha ja
+ * calculada de cada coluna, e para cada faixa de linhas as ultimas reach colunas.
+ */
+template <class T, class F>
+vector<T> wavefront(int rows, int cols, F recurrence, const T &outside, int reach = 1,
+		int tileRows = 64, int tileCols = 256, unsigned numThreads = 0)
+{
+	if (rows <= 0 || cols <= 0)
+		return vector<T>();
+	reach = max(reach, 1);
+	tileRows = max(tileRows, 1);
+	tileCols = max(tileCols, 1);
+	int bands = (rows + tileRows - 1) / tileRows;
+	int tiles = (cols + tileCols - 1) / tileCols;
+
+	vector<T> edge(cols, outside);                     // ultima linha calculada de cada coluna
+	vector<T> corner(bands, outside);                  // (i0-1, j0-1) do proximo bloco de cada faixa
+	vector<vector<T> > window(bands, vector<T>((size_t) tileRows * reach, outside));   // ultimas reach colunas
+
+	auto runTile = [&](int band, int tile) {
+		int i0 = band * tileRows, h = min(tileRows, rows - i0);
+		int j0 = tile * tileCols, w = min(tileCols, cols - j0);
+		int stride = reach + w;
+		vector<T> local((size_t) h * stride);
+		vector<T> &win = window[band];
+		for (int r = 0; r < h; r++)
+			copy(win.begin() + (size_t) r * reach, win.begin() + (size_t) (r + 1) * reach,
+					local.begin() + (size_t) r * stride);
+
+		for (int r = 0; r < h; r++) {
+			T *row = &local[(size_t) r * stride + reach];
+			const T *above = r == 0 ? NULL : row - stride;
+			for (int c = 0; c < w; c++) {
+				int j = j0 + c;
+				const T &up = r == 0 ? edge[j] : above[c];
+				const T &diag = r == 0 ? (c == 0 ? corner[band] : edge[j - 1]) : above[c - 1];
+				row[c] = recurrence(i0 + r, j, up, diag, WavefrontRow<T>(row + c));
+			}
+		}
+
+		corner[band] = edge[j0 + w - 1];
+		copy(local.begin() + (size_t) (h - 1) * stride + reach, local.begin() + (size_t) h * stride,
+				edge.begin() + j0);
+		for (int r = 0; r < h; r++)
+			copy(local.begin() + (size_t) r * stride + w, local.begin() + (size_t) r * stride + w + reach,
+					win.begin() + (size_t) r * reach);
+	};
+
+	unique_ptr<ThreadPool> pool;
+	if (numThreads != 1 && bands > 1 && tiles > 1)
+		pool.reset(new ThreadPool(numThreads));
+
+	for (int diagonal = 0; diagonal < bands + tiles - 1; diagonal++) {
+		int first = max(0, diagonal - tiles + 1), last = min(bands - 1, diagonal);
+		if (!pool || first == last) {
+			for (int band = first; band <= last; band++)
+				runTile(band, diagonal - band);
+			continue;
+		}
+		vector<future<void> > running;
+		for (int band = first; band <= last; band++)
+			running.push_back(pool->submit([&runTile, band, diagonal] { runTile(band, diagonal - band); }));
+		for (future<void> &f : running)
+			f.get();
+	}
+	return edge;
+}
+
+#endif /* WAVEFRONTDP_H_ */
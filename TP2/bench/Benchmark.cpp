@@ -0,0 +1,261 @@
+/*
+ * Benchmark.cpp
+ *
+ * Gera labirintos de tamanho crescente (Kruskal, Wilson, grutas e salas abertas) e mede
+ * neles todos os algoritmos de procura de TP2, escrevendo os resultados em CSV no stdout,
+ * uma linha por caso:
+ *
+ *   generator,algorithm,width,height,cells,calls,time_us,expanded,peak_bytes,path_length
+ *
+ * Em cada labirinto procura-se um caminho da primeira celula livre (a contar do canto
+ * superior esquerdo) ate a ultima celula livre ligada a ela, que passa a ser o objectivo.
+ * Cada chamada inclui a construcao do solver, por isso peak_bytes (o maximo de memoria
+ * alocada pelo caso, acima da que ja estava alocada) inclui o seu estado. time_us e a media
+ * por chamada; expanded e o trabalho reportado pelo algoritmo (celulas expandidas, pontos
+ * de salto no JPS, celulas alcancadas no flood fill, distancias calculadas no campo de
+ * distancias) e fica vazio quando nao se aplica, tal como path_length. A linha "generate"
+ * mede a geracao do proprio labirinto.
+ *
+ * Compilacao (junto com as fontes de TP2, excepto Test.cpp que tem o seu main):
+ *   g++ -std=c++14 -O2 -pthread -o benchmark bench/Benchmark.cpp src/Labirinth.cpp \
+ *       src/MazeSolver.cpp src/MazeComponents.cpp src/MazeFloodFill.cpp src/MazeDistances.cpp \
+ *       src/WeightedLabirinth.cpp src/MazeGenerator.cpp
+ * (com -mavx2 o flood fill usa AVX2)
+ *
+ * Opcoes: --quick (ate 10^6 celulas), --max-cells <n> (10^8 por omissao),
+ *         --generator <nome> e --filter <algoritmo> (so os casos cujo nome o contem),
+ *         --min-time <ms> (tempo minimo medido por caso, 100 por omissao), --seed <n>.
+ * O Wilson so corre ate 10^6 celulas: os primeiros passeios aleatorios crescem muito depressa.
+ */
+
+#include "../src/Labirinth.h"
+#include "../src/MazeSolver.h"
+#include "../src/MazeComponents.h"
+#include "../src/MazeFloodFill.h"
+#include "../src/MazeDistances.h"
+#include "../src/WeightedLabirinth.h"
+#include "../src/MazeGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <vector>
+
+/* Contagem de alocacoes: o operator new global guarda o tamanho antes do bloco. */
+static atomic<long long> liveBytes(0), peakBytes(0);
+static const size_t HEADER = 16;   // mantem o alinhamento de malloc
+
+void* operator new(size_t size)
+{
+	char *block = (char*) malloc(size + HEADER);
+	if (block == NULL)
+		throw bad_alloc();
+	*(size_t*) block = size;
+	long long live = liveBytes.fetch_add(size, memory_order_relaxed) + size;
+	long long peak = peakBytes.load(memory_order_relaxed);
+	while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+		;
+	return block + HEADER;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (ptr == NULL)
+		return;
+	char *block = (char*) ptr - HEADER;
+	liveBytes.fetch_sub(*(size_t*) block, memory_order_relaxed);
+	free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+/* Impede o compilador de eliminar chamadas cujo resultado nao e usado. */
+static volatile long long sink;
+
+/* Resultado de uma chamada; -1 = nao se aplica. */
+struct BenchResult {
+	long long expanded;
+	long long pathLength;
+};
+
+struct BenchMaze {
+	string generator;
+	Labirinth lab;
+	int startX, startY, goalX, goalY;
+};
+
+static void printField(long long value)
+{
+	if (value >= 0)
+		printf(",%lld", value);
+	else
+		printf(",");
+}
+
+static void measure(const BenchMaze &maze, const string &algorithm, double minTimeMs,
+		const function<BenchResult()> &run)
+{
+	typedef chrono::steady_clock Clock;
+	long long live0 = liveBytes.load();
+	peakBytes.store(live0);
+
+	// sem aquecimento: nos labirintos grandes uma chamada ja passa o tempo minimo
+	long long calls = 0, batch = 1;
+	BenchResult result;
+	Clock::time_point start = Clock::now();
+	double elapsedUs = 0;
+	do {
+		for (long long i = 0; i < batch; i++)
+			result = run();
+		calls += batch;
+		batch = min(batch * 2, 1LL << 12);
+		elapsedUs = chrono::duration<double, micro>(Clock::now() - start).count();
+	} while (elapsedUs < minTimeMs * 1000);
+
+	const Labirinth &lab = maze.lab;
+	printf("%s,%s,%d,%d,%lld,%lld,%.3f", maze.generator.c_str(), algorithm.c_str(), lab.getWidth(),
+			lab.getHeight(), (long long) lab.getWidth() * lab.getHeight(), calls, elapsedUs / calls);
+	printField(result.expanded);
+	printf(",%lld", peakBytes.load() - live0);
+	printField(result.pathLength);
+	printf("\n");
+	fflush(stdout);
+}
+
+/* Partida na primeira celula livre; objectivo na ultima celula livre ligada a partida. */
+static void placeGoal(BenchMaze &maze)
+{
+	Labirinth &lab = maze.lab;
+	int w = lab.getWidth(), h = lab.getHeight();
+	maze.startX = maze.startY = maze.goalX = maze.goalY = 0;
+	for (long long i = 0; i < (long long) w * h; i++)
+		if (lab.getCell(i % w, i / w) != Labirinth::WALL) {
+			maze.startX = i % w;
+			maze.startY = i / w;
+			break;
+		}
+	MazeComponents components(lab);
+	for (long long i = (long long) w * h - 1; i >= 0; i--)
+		if (components.connected(maze.startX, maze.startY, i % w, i / w)) {
+			maze.goalX = i % w;
+			maze.goalY = i / w;
+			break;
+		}
+	if (lab.getCell(maze.goalX, maze.goalY) != Labirinth::WALL)
+		lab.setCell(maze.goalX, maze.goalY, Labirinth::GOAL);
+}
+
+static void runMaze(BenchMaze &maze, const string &filter, double minTimeMs)
+{
+	const int sx = maze.startX, sy = maze.startY, gx = maze.goalX, gy = maze.goalY;
+	Labirinth &lab = maze.lab;
+	auto add = [&](const string &algorithm, const function<BenchResult()> &run) {
+		if (filter.empty() || algorithm.find(filter) != string::npos)
+			measure(maze, algorithm, minTimeMs, run);
+	};
+
+	static const char *SOLVER_NAMES[] = { "bfs", "astar", "jps", "bidirectional" };
+	for (int a = MazeSolver::BFS; a <= MazeSolver::BIDIRECTIONAL; a++)
+		add(SOLVER_NAMES[a], [&, a] {
+			MazeSolver solver(lab);
+			MazePath path;
+			bool found = solver.findPath(sx, sy, gx, gy, path, (MazeSolver::Algorithm) a);
+			return BenchResult{solver.getExpanded(), found ? (long long) path.size() : -1};
+		});
+	add("findGoal", [&] {
+		MazeSolver solver(lab);
+		MazePath path;
+		bool found = solver.findGoal(sx, sy, path);
+		return BenchResult{solver.getExpanded(), found ? (long long) path.size() : -1};
+	});
+	add("components", [&] {
+		MazeComponents components(lab);
+		sink += components.canReachGoal(sx, sy);
+		return BenchResult{-1, -1};
+	});
+	add("floodfill", [&] {
+		MazeFloodFill flood(lab);
+		flood.findGoal(sx, sy);
+		return BenchResult{(long long) flood.getReachedCount(), -1};
+	});
+	add("distance_field", [&] {
+		MazeDistances distances(lab);
+		const DistanceField &field = distances.toNearestGoal();
+		uint32_t d = field.getDistance(sx, sy);
+		return BenchResult{field.getUpdated(), d == DistanceField::UNREACHABLE ? -1 : (long long) d};
+	});
+	add("dial", [&] {
+		WeightedLabirinth weighted(lab);
+		WeightedMazeSolver solver(weighted);
+		MazePath path;
+		uint64_t cost = solver.findPath(sx, sy, gx, gy, path);
+		return BenchResult{solver.getExpanded(), cost == WeightedMazeSolver::UNREACHABLE ? -1 : (long long) path.size()};
+	});
+}
+
+int main(int argc, char const *argv[])
+{
+	long long maxCells = 100000000;
+	string filter, generatorFilter;
+	double minTimeMs = 100;
+	unsigned long long seed = 1;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0)
+			maxCells = 1000000;
+		else if (strcmp(argv[i], "--max-cells") == 0 && i + 1 < argc)
+			maxCells = atoll(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--generator") == 0 && i + 1 < argc)
+			generatorFilter = argv[++i];
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+			minTimeMs = atof(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = strtoull(argv[++i], NULL, 10);
+		else {
+			cerr << "uso: " << argv[0] << " [--quick] [--max-cells <n>] [--generator <nome>]"
+					" [--filter <algoritmo>] [--min-time <ms>] [--seed <n>]" << endl;
+			return 1;
+		}
+	}
+
+	struct Generator {
+		string name;
+		long long maxCells;
+		function<Labirinth(int)> make;
+	};
+	vector<Generator> generators = {
+		{ "kruskal", 100000000, [seed](int side) { return MazeGenerator::kruskal(side, side, seed); } },
+		{ "wilson", 1000000, [seed](int side) { return MazeGenerator::wilson(side, side, seed); } },
+		{ "caves", 100000000, [seed](int side) { return MazeGenerator::caves(side, side, seed); } },
+		{ "rooms", 100000000, [seed](int side) { return MazeGenerator::rooms(side, side, seed); } },
+	};
+
+	printf("generator,algorithm,width,height,cells,calls,time_us,expanded,peak_bytes,path_length\n");
+	for (int side : { 100, 316, 1000, 3162, 10000 })
+		for (const Generator &g : generators) {
+			long long cells = (long long) side * side;
+			if (cells > maxCells || cells > g.maxCells)
+				continue;
+			if (!generatorFilter.empty() && g.name.find(generatorFilter) == string::npos)
+				continue;
+			BenchMaze maze{g.name, Labirinth(0, 0), 0, 0, 0, 0};
+			if (filter.empty() || string("generate").find(filter) != string::npos)
+				measure(maze, "generate", 0, [&] {
+					maze.lab = g.make(side);
+					return BenchResult{-1, -1};
+				});
+			else
+				maze.lab = g.make(side);
+			placeGoal(maze);
+			runMaze(maze, filter, minTimeMs);
+		}
+	return 0;
+}
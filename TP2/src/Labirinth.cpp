@@ -3,63 +3,292 @@
  */
 
 #include "Labirinth.h"
+#include "MazeSolver.h"
 
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
+/**
+ * Ficheiro mapeado em memoria so de leitura; desfaz o mapeamento no destrutor.
+ */
+struct MappedFile {
+	const char *data;
+	size_t size;
+
+	MappedFile(const string &path) : data(NULL), size(0) {
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw runtime_error("Labirinth: cannot open " + path);
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size == 0) {
+			close(fd);
+			throw runtime_error("Labirinth: empty or unreadable file " + path);
+		}
+		void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (p == MAP_FAILED)
+			throw runtime_error("Labirinth: cannot map " + path);
+		data = (const char*) p;
+		size = st.st_size;
+	}
+
+	~MappedFile() {
+		munmap((void*) data, size);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+};
+
+/* Cabecalho do formato binario; as celulas seguem-no, alinhadas a 8 bytes. */
+struct BinaryHeader {
+	char magic[4];
+	uint32_t width;
+	uint32_t height;
+	uint32_t rowWords;
+};
 
+static const char BINARY_MAGIC[4] = {'L', 'A', 'B', '2'};
 
-Labirinth::Labirinth(int values[10][10])
+const int Labirinth::WALL;
+const int Labirinth::FREE;
+const int Labirinth::GOAL;
+
+
+Labirinth::Labirinth(int values[10][10]) : Labirinth(10, 10, &values[0][0])
 {
-	for (int i = 0; i < 10; i++)
-		for (int j = 0; j < 10; j++) {
-			labirinth[i][j] = values[i][j];
-		}
-	this->initializeVisited();
 }
 
+static int checkedSize(int size)
+{
+	if (size < 0)
+		throw invalid_argument("Labirinth: negative size");
+	return size;
+}
 
-void Labirinth::initializeVisited()
+Labirinth::Labirinth(int width, int height)
+	: width(checkedSize(width)), height(checkedSize(height)), rowWords((width + 31) / 32),
+	  storage(rowWords * height, 0), mappedCells(NULL)
 {
-	for (int i = 0; i < 10; i++)
-		for (int j = 0; j < 10; j++)
-			visited[i][j] = false;
 }
 
+Labirinth::Labirinth(int width, int height, const int *values) : Labirinth(width, height)
+{
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (values[(size_t) y * width + x] != WALL)
+				setCell(x, y, values[(size_t) y * width + x]);
+}
 
+void Labirinth::setCell(int x, int y, int value)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		throw out_of_range("Labirinth: cell outside the maze");
+	if (value < WALL || value > GOAL)
+		throw invalid_argument("Labirinth: cell value must be 0, 1 or 2");
+	if (mappedCells) {
+		storage.assign(mappedCells, mappedCells + rowWords * height);
+		mappedCells = NULL;
+		mapped.reset();
+	}
+	uint64_t &word = storage[y * rowWords + (x >> 5)];
+	int shift = (x & 31) * 2;
+	word = (word & ~(3ULL << shift)) | ((uint64_t) value << shift);
+}
 
+/* Junta os bits pares de v (um por celula) nos 32 bits de baixo. */
+static uint64_t compressEvenBits(uint64_t v)
+{
+	v &= 0x5555555555555555ULL;
+	v = (v | (v >> 1)) & 0x3333333333333333ULL;
+	v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+	v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+	v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+	return (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+}
 
-void  Labirinth::printLabirinth()
+void Labirinth::getFreeBits(int y, uint64_t *out) const
 {
-	for (int i = 0; i < 10; i++)
-	{
-		for (int j = 0; j < 10; j++)
-			cout << labirinth[i][j] << " ";
+	const uint64_t *row = getRow(y);
+	for (size_t i = 0; i < rowWords; i++) {
+		uint64_t bits = compressEvenBits(row[i] | (row[i] >> 1));
+		if (i & 1)
+			out[i >> 1] |= bits << 32;
+		else
+			out[i >> 1] = bits;
+	}
+}
 
-		cout << endl;
+void Labirinth::getGoalBits(int y, uint64_t *out) const
+{
+	const uint64_t *row = getRow(y);
+	for (size_t i = 0; i < rowWords; i++) {
+		uint64_t bits = compressEvenBits((row[i] >> 1) & ~row[i]);
+		if (i & 1)
+			out[i >> 1] |= bits << 32;
+		else
+			out[i >> 1] = bits;
 	}
 }
 
 
-bool Labirinth::findGoal(int x, int y)
+Labirinth Labirinth::load(const string &path)
+{
+	shared_ptr<const MappedFile> file = make_shared<const MappedFile>(path);
+	const char *begin = file->data, *end = file->data + file->size;
+	if (file->size >= sizeof(BinaryHeader) && memcmp(begin, BINARY_MAGIC, 4) == 0)
+		return loadBinary(file);
+	if (file->size >= 5 && memcmp(begin, "type ", 5) == 0)
+		return loadMovingAI(begin, end);
+	return loadText(begin, end);
+}
+
+Labirinth Labirinth::loadBinary(const shared_ptr<const MappedFile> &file)
+{
+	BinaryHeader header;
+	memcpy(&header, file->data, sizeof(header));
+	if (header.width > (uint32_t) INT32_MAX || header.height > (uint32_t) INT32_MAX
+			|| header.rowWords != (header.width + 31) / 32
+			|| file->size != sizeof(header) + (size_t) header.rowWords * header.height * sizeof(uint64_t))
+		throw runtime_error("Labirinth: malformed binary maze");
+
+	Labirinth lab(0, 0);
+	lab.width = header.width;
+	lab.height = header.height;
+	lab.rowWords = header.rowWords;
+	lab.mapped = file;
+	lab.mappedCells = (const uint64_t*) (file->data + sizeof(header));
+	return lab;
+}
+
+/* Fim da linha que comeca em p (sem o '\r' de um fim de linha Windows). */
+static const char* lineEnd(const char *p, const char *end, const char **next)
 {
+	const char *nl = (const char*) memchr(p, '\n', end - p);
+	*next = nl ? nl + 1 : end;
+	const char *e = nl ? nl : end;
+	if (e > p && e[-1] == '\r')
+		e--;
+	return e;
+}
 
-	if(labirinth[y][x] == 2) {
-		cout << "Solution at x: " << x << " y: " << y << endl;
-		return true;
+Labirinth Labirinth::loadText(const char *begin, const char *end)
+{
+	// 1a passagem: dimensoes
+	int width = -1, height = 0;
+	for (const char *p = begin, *next; p < end; p = next) {
+		const char *e = lineEnd(p, end, &next);
+		int cells = 0;
+		for (const char *c = p; c < e; c++) {
+			if (*c >= '0' && *c <= '2')
+				cells++;
+			else if (*c != ' ' && *c != '\t' && *c != ',')
+				throw runtime_error("Labirinth: unexpected character in text maze");
+		}
+		if (cells == 0)
+			continue;
+		if (width >= 0 && cells != width)
+			throw runtime_error("Labirinth: rows of different lengths in text maze");
+		width = cells;
+		height++;
 	}
-	if(labirinth[y][x] == 0 || visited[y][x]) {
-		return false;
+	if (width < 0)
+		throw runtime_error("Labirinth: empty text maze");
+
+	// 2a passagem: celulas, escritas directamente nas palavras
+	Labirinth lab(width, height);
+	uint64_t *cells = lab.storage.data();
+	int y = 0;
+	for (const char *p = begin, *next; p < end; p = next) {
+		const char *e = lineEnd(p, end, &next);
+		int x = 0;
+		uint64_t *row = cells + y * lab.rowWords;
+		for (const char *c = p; c < e; c++)
+			if (*c >= '0' && *c <= '2') {
+				row[x >> 5] |= (uint64_t) (*c - '0') << ((x & 31) * 2);
+				x++;
+			}
+		if (x > 0)
+			y++;
 	}
-	visited[y][x] = true;
-	if(labirinth[y][x] == 1) {
-		if (findGoal(x + 1, y)) return true;
-		else if (findGoal(x, y + 1)) return true;
-		else if (findGoal(x - 1, y)) return true;
-		else return (findGoal(x, y + 1));
+	return lab;
+}
 
+Labirinth Labirinth::loadMovingAI(const char *begin, const char *end)
+{
+	int width = -1, height = -1;
+	const char *p = begin, *next;
+	for (; p < end; p = next) {
+		const char *e = lineEnd(p, end, &next);
+		string line(p, e);
+		if (line == "map") {
+			p = next;
+			break;
+		}
+		if (sscanf(line.c_str(), "height %d", &height) == 1 || sscanf(line.c_str(), "width %d", &width) == 1)
+			continue;
+		if (line.compare(0, 5, "type ") != 0 && !line.empty())
+			throw runtime_error("Labirinth: unexpected MovingAI header line: " + line);
+	}
+	if (width < 0 || height < 0)
+		throw runtime_error("Labirinth: MovingAI map without width/height");
+
+	Labirinth lab(width, height);
+	uint64_t *cells = lab.storage.data();
+	for (int y = 0; y < height; y++, p = next) {
+		if (p >= end)
+			throw runtime_error("Labirinth: MovingAI map with missing rows");
+		const char *e = lineEnd(p, end, &next);
+		if (e - p != width)
+			throw runtime_error("Labirinth: MovingAI row with wrong width");
+		uint64_t *row = cells + y * lab.rowWords;
+		for (int x = 0; x < width; x++)
+			if (p[x] == '.' || p[x] == 'G' || p[x] == 'S')
+				row[x >> 5] |= (uint64_t) FREE << ((x & 31) * 2);
+	}
+	return lab;
+}
+
+void Labirinth::save(const string &path) const
+{
+	FILE *f = fopen(path.c_str(), "wb");
+	if (f == NULL)
+		throw runtime_error("Labirinth: cannot write " + path);
+	BinaryHeader header;
+	memcpy(header.magic, BINARY_MAGIC, 4);
+	header.width = width;
+	header.height = height;
+	header.rowWords = rowWords;
+	size_t words = rowWords * height;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1
+			&& (words == 0 || fwrite(getRow(0), sizeof(uint64_t), words, f) == words);
+	if (fclose(f) != 0 || !ok)
+		throw runtime_error("Labirinth: cannot write " + path);
+}
+
+
+void  Labirinth::printLabirinth()
+{
+	for (int i = 0; i < height; i++)
+	{
+		for (int j = 0; j < width; j++)
+			cout << getCell(j, i) << " ";
+
+		cout << endl;
 	}
-	return false;
 }
 
 
+bool Labirinth::findGoal(int x, int y)
+{
+	MazeSolver solver(*this);
+	MazePath path;
+	return solver.findGoal(x, y, path);
+}
@@ -6,14 +6,103 @@
 #ifndef LABIRINTH_H_
 #define LABIRINTH_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
 
+struct MappedFile;
+
+/**
+ * Labirinto de dimensao arbitraria. Cada celula vale 0 (parede), 1 (livre) ou 2 (objectivo).
+ *
+ * As celulas ocupam 2 bits, 32 por palavra de 64 bits; cada linha comeca numa palavra nova
+ * (getRowWords() palavras por linha). As celulas fora do labirinto sao paredes.
+ * As pesquisas (MazeSolver) guardam o seu proprio estado, a parte das celulas.
+ */
 class Labirinth {
-	int labirinth[10][10];
-	bool visited[10][10];
-	void initializeVisited();
+	int width, height;
+	size_t rowWords;
+	vector<uint64_t> storage;              // celulas, se o labirinto nao vier de um ficheiro binario
+	shared_ptr<const MappedFile> mapped;   // ficheiro binario mapeado (partilhado entre copias)
+	const uint64_t *mappedCells;           // celulas dentro do ficheiro mapeado
+
+	static Labirinth loadText(const char *begin, const char *end);
+	static Labirinth loadMovingAI(const char *begin, const char *end);
+	static Labirinth loadBinary(const shared_ptr<const MappedFile> &file);
+
 public:
+	static const int WALL = 0;
+	static const int FREE = 1;
+	static const int GOAL = 2;
+
 	Labirinth(int values[10][10]);
+
+	/**
+	 * Labirinto width x height so com paredes.
+	 */
+	Labirinth(int width, int height);
+
+	/**
+	 * Labirinto width x height com as celulas values[y * width + x].
+	 */
+	Labirinth(int width, int height, const int *values);
+
+	/**
+	 * Le um labirinto de um ficheiro (mapeado com mmap). O formato e detectado pelo inicio:
+	 *  - binario (gravado com save): cabecalho "LAB2" e as celulas ja no formato interno;
+	 *    nao ha copia, as celulas sao lidas directamente do ficheiro mapeado;
+	 *  - MovingAI (.map): "type ...", "height H", "width W", "map" e H linhas de W caracteres,
+	 *    em que '.', 'G' e 'S' sao livres e os restantes paredes;
+	 *  - texto: uma linha por linha do labirinto, com os digitos 0, 1 e 2 (espacos, tabs
+	 *    e virgulas sao ignorados).
+	 * Lanca runtime_error se o ficheiro nao puder ser lido ou estiver mal formado.
+	 */
+	static Labirinth load(const string &path);
+
+	/**
+	 * Grava o labirinto no formato binario lido por load.
+	 * Lanca runtime_error se o ficheiro nao puder ser escrito.
+	 */
+	void save(const string &path) const;
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	int getCell(int x, int y) const {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return WALL;
+		return (getRow(y)[x >> 5] >> ((x & 31) * 2)) & 3;
+	}
+
+	/**
+	 * Altera uma celula. Se as celulas vinham de um ficheiro mapeado, passam antes a ser copiadas.
+	 */
+	void setCell(int x, int y, int value);
+
+	/**
+	 * Linha y em bruto (2 bits por celula, celula x nos bits 2*(x%32) da palavra x/32),
+	 * para os algoritmos que percorrem o labirinto sem passar por getCell.
+	 */
+	const uint64_t* getRow(int y) const { return (mappedCells ? mappedCells : storage.data()) + y * rowWords; }
+	size_t getRowWords() const { return rowWords; }
+
+	/**
+	 * Linha y como bitset de 64 celulas por palavra ((width + 63) / 64 palavras em out):
+	 * o bit x indica se a celula x nao e parede (getFreeBits) ou se e objectivo (getGoalBits).
+	 * Os bits a partir de width ficam a 0.
+	 */
+	void getFreeBits(int y, uint64_t *out) const;
+	void getGoalBits(int y, uint64_t *out) const;
+
 	void printLabirinth();
+
+	/**
+	 * Indica se alguma celula objectivo e alcancavel a partir de (x, y).
+	 * Para varias pesquisas, ou para obter o caminho, usar um MazeSolver.
+	 */
 	bool findGoal(int x, int y);
 };
 
@@ -0,0 +1,211 @@
+/*
+ * MazeComponents.cpp
+ *
+ */
+
+#include "MazeComponents.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/* Sequencia de celulas livres [begin, end) de uma linha, com o seu numero provisorio. */
+struct Run {
+	int begin, end;
+	uint32_t id;
+};
+
+/* Acrescenta a runs as sequencias de bits a 1 de bits (words palavras de 64 bits). */
+static void findRuns(const uint64_t *bits, size_t words, uint32_t &nextId, vector<Run> &runs)
+{
+	runs.clear();
+	for (size_t i = 0; i < words; i++) {
+		uint64_t w = bits[i];
+		while (w != 0) {
+			int begin = i * 64 + __builtin_ctzll(w);
+			// avanca ate ao primeiro 0, possivelmente em palavras seguintes
+			uint64_t rest = ~w & (~0ULL << (begin & 63));
+			while (rest == 0 && ++i < words)
+				rest = ~bits[i];
+			int end = i < words ? (int) (i * 64 + __builtin_ctzll(rest)) : (int) (words * 64);
+			Run r = { begin, end, nextId++ };
+			runs.push_back(r);
+			if (i >= words)
+				return;
+			w = bits[i] & (~0ULL << (end & 63));
+		}
+	}
+}
+
+/* Union-find sem locks: cada raiz e o menor numero do seu conjunto e as ligacoes sao
+ * feitas por compare-and-swap, sempre de uma raiz maior para uma menor (sem ciclos).
+ * O find encurta os caminhos (path halving) tambem por CAS. */
+static uint32_t findRoot(atomic<uint32_t> *parent, uint32_t x)
+{
+	for (;;) {
+		uint32_t p = parent[x].load(memory_order_relaxed);
+		if (p == x)
+			return x;
+		uint32_t gp = parent[p].load(memory_order_relaxed);
+		if (gp != p)
+			parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+		x = gp;
+	}
+}
+
+static void unite(atomic<uint32_t> *parent, uint32_t a, uint32_t b)
+{
+	for (;;) {
+		a = findRoot(parent, a);
+		b = findRoot(parent, b);
+		if (a == b)
+			return;
+		if (a > b)
+			swap(a, b);
+		uint32_t expected = b;
+		if (parent[b].compare_exchange_strong(expected, a, memory_order_relaxed))
+			return;
+	}
+}
+
+/* Une as sequencias de duas linhas consecutivas que tem alguma coluna em comum. */
+static void unionRows(const vector<Run> &above, const vector<Run> &below, atomic<uint32_t> *parent)
+{
+	size_t i = 0, j = 0;
+	while (i < above.size() && j < below.size()) {
+		if (above[i].begin < below[j].end && below[j].begin < above[i].end)
+			unite(parent, above[i].id, below[j].id);
+		if (above[i].end < below[j].end)
+			i++;
+		else
+			j++;
+	}
+}
+
+/* Numero de sequencias de bits a 1 (comecos de sequencia) num bitset. */
+static uint32_t countRuns(const uint64_t *bits, size_t words)
+{
+	uint32_t runs = 0;
+	uint64_t carry = 0;
+	for (size_t i = 0; i < words; i++) {
+		runs += __builtin_popcountll(bits[i] & ~((bits[i] << 1) | carry));
+		carry = bits[i] >> 63;
+	}
+	return runs;
+}
+
+/* Faixa de linhas [y0, y1) tratada por uma thread. */
+struct Strip {
+	int y0, y1;
+	uint32_t firstId, runs;
+	vector<Run> firstRow, lastRow;
+	vector<uint32_t> goalLabels;
+};
+
+/* Executa task(i) para 0 <= i < count, cada um na sua thread (o ultimo na thread actual). */
+template <class Task>
+static void runStrips(size_t count, Task task)
+{
+	vector<thread> threads;
+	for (size_t i = 0; i + 1 < count; i++)
+		threads.push_back(thread(task, i));
+	if (count > 0)
+		task(count - 1);
+	for (thread &t : threads)
+		t.join();
+}
+
+MazeComponents::MazeComponents(const Labirinth &lab, unsigned numThreads)
+	: width(lab.getWidth()), height(lab.getHeight()), labels((size_t) width * height, 0), count(0)
+{
+	size_t words = (width + 63) / 64;
+	if (numThreads == 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	int numStrips = max(1, min((int) numThreads, height / MIN_STRIP_ROWS));
+	vector<Strip> strips(numStrips);
+	for (int s = 0; s < numStrips; s++) {
+		strips[s].y0 = (long long) height * s / numStrips;
+		strips[s].y1 = (long long) height * (s + 1) / numStrips;
+	}
+
+	// 1: numero de sequencias de cada faixa, para cada uma ter os seus numeros provisorios
+	runStrips(numStrips, [&](size_t s) {
+		vector<uint64_t> bits(words);
+		strips[s].runs = 0;
+		for (int y = strips[s].y0; y < strips[s].y1; y++) {
+			lab.getFreeBits(y, bits.data());
+			strips[s].runs += countRuns(bits.data(), words);
+		}
+	});
+	uint32_t totalRuns = 0;
+	for (Strip &strip : strips) {
+		strip.firstId = totalRuns;
+		totalRuns += strip.runs;
+	}
+	unique_ptr<atomic<uint32_t>[]> parent(new atomic<uint32_t>[totalRuns]);
+	for (uint32_t id = 0; id < totalRuns; id++)
+		parent[id].store(id, memory_order_relaxed);
+
+	// 2: unioes dentro de cada faixa
+	runStrips(numStrips, [&](size_t s) {
+		Strip &strip = strips[s];
+		vector<uint64_t> bits(words);
+		vector<Run> above, below;
+		uint32_t nextId = strip.firstId;
+		for (int y = strip.y0; y < strip.y1; y++) {
+			lab.getFreeBits(y, bits.data());
+			findRuns(bits.data(), words, nextId, below);
+			if (y == strip.y0)
+				strip.firstRow = below;
+			unionRows(above, below, parent.get());
+			above.swap(below);
+		}
+		strip.lastRow.swap(above);
+	});
+
+	// 3: unioes nas fronteiras entre faixas (varias fronteiras podem tocar no mesmo conjunto)
+	runStrips(numStrips - 1, [&](size_t s) {
+		unionRows(strips[s].lastRow, strips[s + 1].firstRow, parent.get());
+	});
+
+	// numeros finais, pela ordem da primeira celula de cada componente (como numa so faixa)
+	vector<uint32_t> component(totalRuns, 0);
+	for (uint32_t id = 0; id < totalRuns; id++) {
+		uint32_t root = findRoot(parent.get(), id);
+		component[id] = root == id ? ++count : component[root];
+	}
+	parent.reset();
+
+	// 4: grelha de numeros, com as mesmas sequencias e numeros provisorios
+	runStrips(numStrips, [&](size_t s) {
+		Strip &strip = strips[s];
+		vector<uint64_t> bits(words), goals(words);
+		vector<Run> runs;
+		uint32_t nextId = strip.firstId;
+		for (int y = strip.y0; y < strip.y1; y++) {
+			lab.getFreeBits(y, bits.data());
+			lab.getGoalBits(y, goals.data());
+			findRuns(bits.data(), words, nextId, runs);
+			uint32_t *row = labels.data() + (size_t) y * width;
+			for (const Run &r : runs)
+				fill(row + r.begin, row + r.end, component[r.id]);
+			for (size_t i = 0; i < words; i++)
+				for (uint64_t g = goals[i]; g != 0; g &= g - 1)
+					strip.goalLabels.push_back(row[i * 64 + __builtin_ctzll(g)]);
+		}
+	});
+
+	goalComponent.assign(count + 1, false);
+	for (const Strip &strip : strips)
+		for (uint32_t c : strip.goalLabels)
+			goalComponent[c] = true;
+}
+
+vector<bool> MazeComponents::canReachGoal(const vector<pair<int,int> > &starts) const
+{
+	vector<bool> res(starts.size());
+	for (size_t i = 0; i < starts.size(); i++)
+		res[i] = canReachGoal(starts[i].first, starts[i].second);
+	return res;
+}
@@ -0,0 +1,76 @@
+/*
+ * MazeComponents.h
+ *
+ */
+
+#ifndef MAZECOMPONENTS_H_
+#define MAZECOMPONENTS_H_
+
+#include "Labirinth.h"
+
+/**
+ * Componentes conexas (4 vizinhos) das celulas livres de um Labirinth, calculadas uma vez.
+ *
+ * Cada linha e dividida em sequencias de celulas livres consecutivas; as sequencias de
+ * linhas seguidas que se tocam sao unidas numa estrutura union-find, e no fim cada celula
+ * fica com o numero da sua componente numa grelha de uint32 (0 nas paredes).
+ *
+ * Depois disso, saber se duas celulas estao ligadas, ou se de uma celula se chega a um
+ * objectivo, e uma comparacao em O(1), sem pesquisa.
+ *
+ * Em labirintos grandes as linhas sao divididas em faixas horizontais, uma por thread:
+ * cada faixa une as suas sequencias, depois juntam-se as sequencias das fronteiras entre
+ * faixas (em paralelo, numa union-find sem locks) e por fim cada faixa escreve os seus
+ * numeros. Como cada conjunto fica representado pela sua primeira sequencia, os numeros
+ * sao os mesmos com qualquer numero de threads.
+ *
+ * As componentes correspondem ao labirinto no momento da construcao.
+ */
+class MazeComponents {
+	int width, height;
+	vector<uint32_t> labels;        // labels[y * width + x]: 0 = parede, senao 1..count
+	vector<bool> goalComponent;     // goalComponent[c]: a componente c tem uma celula objectivo
+	uint32_t count;
+
+	static const int MIN_STRIP_ROWS = 64;   // faixas mais pequenas nao compensam uma thread
+
+public:
+	/**
+	 * Calcula as componentes em numThreads threads (0 = numero de cores).
+	 */
+	MazeComponents(const Labirinth &lab, unsigned numThreads = 0);
+
+	/**
+	 * Numero de componentes.
+	 */
+	uint32_t getCount() const { return count; }
+
+	/**
+	 * Componente da celula (x, y), de 1 a getCount(); 0 nas paredes e fora do labirinto.
+	 */
+	uint32_t getLabel(int x, int y) const {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return 0;
+		return labels[(size_t) y * width + x];
+	}
+
+	/**
+	 * Indica se ha caminho entre as celulas (x1, y1) e (x2, y2).
+	 */
+	bool connected(int x1, int y1, int x2, int y2) const {
+		uint32_t label = getLabel(x1, y1);
+		return label != 0 && label == getLabel(x2, y2);
+	}
+
+	/**
+	 * Indica se de (x, y) se chega a alguma celula objectivo (o mesmo que Labirinth::findGoal).
+	 */
+	bool canReachGoal(int x, int y) const { return goalComponent[getLabel(x, y)]; }
+
+	/**
+	 * canReachGoal para varias celulas de partida de uma vez.
+	 */
+	vector<bool> canReachGoal(const vector<pair<int,int> > &starts) const;
+};
+
+#endif /* MAZECOMPONENTS_H_ */
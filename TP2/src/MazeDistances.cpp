@@ -0,0 +1,181 @@
+/*
+ * MazeDistances.cpp
+ *
+ */
+
+#include "MazeDistances.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const uint32_t DistanceField::UNREACHABLE;
+
+DistanceField::DistanceField(const Labirinth &lab, long long goal)
+	: lab(lab), width(lab.getWidth()), height(lab.getHeight()), goal(goal),
+	  dist((size_t) width * height, UNREACHABLE), updated(0)
+{
+	compute();
+}
+
+/* 1 + menor distancia dos vizinhos (UNREACHABLE se nenhum tiver caminho). */
+uint32_t DistanceField::bestNeighbour(int x, int y) const
+{
+	uint32_t best = UNREACHABLE;
+	for (int d = 0; d < 4; d++)
+		best = min(best, getDistance(x + DIRECTION_DX[d], y + DIRECTION_DY[d]));
+	return best == UNREACHABLE ? best : best + 1;
+}
+
+/* BFS a partir de todas as origens. */
+void DistanceField::compute()
+{
+	seeds.clear();
+	if (goal >= 0) {
+		if (isSource(goal % width, goal / width))
+			seeds.push_back(Entry(0, goal));
+	} else {
+		for (int y = 0; y < height; y++)
+			for (int x = 0; x < width; x++)
+				if (lab.getCell(x, y) == Labirinth::GOAL)
+					seeds.push_back(Entry(0, (uint32_t) y * width + x));
+	}
+	for (const Entry &s : seeds)
+		dist[s.second] = 0;
+	updated = 0;
+	propagate();
+}
+
+/* Propaga as distancias de seeds (por ordem crescente) as celulas vizinhas que melhoram.
+ * As sementes estao ordenadas e a fila cresce por ordem, por isso basta juntar as duas. */
+void DistanceField::propagate()
+{
+	work.clear();
+	size_t next = 0, head = 0;
+	while (next < seeds.size() || head < work.size()) {
+		Entry e;
+		if (head < work.size() && (next == seeds.size() || work[head].first <= seeds[next].first))
+			e = work[head++];
+		else
+			e = seeds[next++];
+		if (dist[e.second] != e.first)
+			continue;
+		updated++;
+		int x = e.second % width, y = e.second / width;
+		for (int d = 0; d < 4; d++) {
+			int nx = x + DIRECTION_DX[d], ny = y + DIRECTION_DY[d];
+			if (lab.getCell(nx, ny) == Labirinth::WALL)
+				continue;
+			uint32_t n = (uint32_t) ny * width + nx;
+			if (dist[n] > e.first + 1) {
+				dist[n] = e.first + 1;
+				work.push_back(Entry(e.first + 1, n));
+			}
+		}
+	}
+}
+
+/* Corrige as distancias depois de a celula (x, y) ter mudado. */
+void DistanceField::update(int x, int y)
+{
+	uint32_t cell = (uint32_t) y * width + x;
+	updated = 0;
+	affected.clear();
+	seeds.clear();
+
+	// 1) celulas que perderam todos os caminhos minimos: (x, y) e as que so dependiam dela,
+	// por ordem crescente de distancia; uma celula mantem-se se tiver um vizinho ainda valido
+	// a distancia d - 1
+	if (dist[cell] != UNREACHABLE && !isSource(x, y)) {
+		work.clear();
+		work.push_back(Entry(dist[cell], cell));
+		for (size_t i = 0; i < work.size(); i++) {
+			uint32_t d = work[i].first, c = work[i].second;
+			if (dist[c] != d)
+				continue;
+			int cx = c % width, cy = c / width;
+			if (lab.getCell(cx, cy) != Labirinth::WALL && d > 0 && bestNeighbour(cx, cy) == d)
+				continue;
+			dist[c] = UNREACHABLE;
+			affected.push_back(c);
+			for (int k = 0; k < 4; k++) {
+				int nx = cx + DIRECTION_DX[k], ny = cy + DIRECTION_DY[k];
+				if (getDistance(nx, ny) == d + 1)
+					work.push_back(Entry(d + 1, (uint32_t) ny * width + nx));
+			}
+		}
+	}
+
+	// 2) essas celulas, e (x, y) se ficou livre, recomecam da fronteira com as restantes
+	affected.push_back(cell);
+	for (uint32_t c : affected) {
+		int cx = c % width, cy = c / width;
+		if (lab.getCell(cx, cy) == Labirinth::WALL)
+			continue;
+		uint32_t d = isSource(cx, cy) ? 0 : bestNeighbour(cx, cy);
+		if (d < dist[c]) {
+			dist[c] = d;
+			seeds.push_back(Entry(d, c));
+		}
+	}
+	sort(seeds.begin(), seeds.end());
+	updated = affected.size() - 1;
+	propagate();
+}
+
+int DistanceField::nextStep(int x, int y) const
+{
+	uint32_t d = getDistance(x, y);
+	if (d == 0 || d == UNREACHABLE)
+		return -1;
+	for (int k = 0; k < 4; k++)
+		if (getDistance(x + DIRECTION_DX[k], y + DIRECTION_DY[k]) == d - 1)
+			return k;
+	return -1;
+}
+
+bool DistanceField::getPath(int x, int y, MazePath &path) const
+{
+	path.clear(x, y);
+	if (getDistance(x, y) == UNREACHABLE)
+		return false;
+	for (int d = nextStep(x, y); d >= 0; d = nextStep(x, y)) {
+		path.push_back((Direction) d);
+		x += DIRECTION_DX[d];
+		y += DIRECTION_DY[d];
+	}
+	return true;
+}
+
+MazeDistances::MazeDistances(Labirinth &lab) : lab(lab)
+{
+}
+
+const DistanceField& MazeDistances::toGoal(int goalX, int goalY)
+{
+	if (lab.getCell(goalX, goalY) != Labirinth::GOAL)
+		throw invalid_argument("MazeDistances: not a goal cell");
+	uint32_t cell = (uint32_t) goalY * lab.getWidth() + goalX;
+	unique_ptr<DistanceField> &field = goalFields[cell];
+	if (!field)
+		field.reset(new DistanceField(lab, cell));
+	return *field;
+}
+
+const DistanceField& MazeDistances::toNearestGoal()
+{
+	if (!nearestField)
+		nearestField.reset(new DistanceField(lab, -1));
+	return *nearestField;
+}
+
+void MazeDistances::setCell(int x, int y, int value)
+{
+	int old = lab.getCell(x, y);
+	lab.setCell(x, y, value);
+	if (old == value)
+		return;
+	for (auto &entry : goalFields)
+		entry.second->update(x, y);
+	if (nearestField)
+		nearestField->update(x, y);
+}
@@ -0,0 +1,116 @@
+/*
+ * MazeDistances.h
+ *
+ */
+
+#ifndef MAZEDISTANCES_H_
+#define MAZEDISTANCES_H_
+
+#include "Labirinth.h"
+#include "MazeSolver.h"
+#include <unordered_map>
+
+/**
+ * Distancia de cada celula a um objectivo (ou ao objectivo mais proximo), em numero de passos.
+ *
+ * Com as distancias calculadas, o caminho minimo de qualquer celula segue o gradiente:
+ * em cada passo vai-se para um vizinho com distancia uma unidade menor, sem pesquisa.
+ * Os campos sao criados e mantidos por um MazeDistances.
+ */
+class DistanceField {
+public:
+	static const uint32_t UNREACHABLE = 0xFFFFFFFF;
+
+	/**
+	 * Passos de (x, y) ate ao objectivo; UNREACHABLE nas paredes e nas celulas sem caminho.
+	 */
+	uint32_t getDistance(int x, int y) const {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return UNREACHABLE;
+		return dist[(size_t) y * width + x];
+	}
+
+	/**
+	 * Direccao do primeiro passo de um caminho minimo de (x, y) ate ao objectivo;
+	 * -1 se (x, y) ja for o objectivo ou nao tiver caminho.
+	 */
+	int nextStep(int x, int y) const;
+
+	/**
+	 * Caminho minimo de (x, y) ate ao objectivo, em O(comprimento do caminho).
+	 * Devolve false (e um caminho vazio) se nao houver caminho.
+	 */
+	bool getPath(int x, int y, MazePath &path) const;
+
+	/**
+	 * Celulas cuja distancia foi recalculada na ultima actualizacao (ou no calculo inicial).
+	 */
+	long long getUpdated() const { return updated; }
+
+private:
+	friend class MazeDistances;
+	typedef pair<uint32_t, uint32_t> Entry;   // (distancia, celula)
+
+	const Labirinth &lab;
+	int width, height;
+	long long goal;              // celula objectivo; -1 = todas as celulas objectivo
+	vector<uint32_t> dist;
+	vector<Entry> work;          // fila das actualizacoes (reaproveitada)
+	vector<Entry> seeds;
+	vector<uint32_t> affected;
+	long long updated;
+
+	DistanceField(const Labirinth &lab, long long goal);
+
+	bool isSource(int x, int y) const {
+		return lab.getCell(x, y) == Labirinth::GOAL && (goal < 0 || (long long) y * width + x == goal);
+	}
+	uint32_t bestNeighbour(int x, int y) const;
+	void compute();
+	void update(int x, int y);
+	void propagate();
+};
+
+/**
+ * Campos de distancia de um Labirinth, guardados para serem partilhados por varias consultas:
+ * um por celula objectivo (valor 2) e um para o objectivo mais proximo (BFS com todas as
+ * celulas objectivo como origem). Cada campo e calculado na primeira vez que e pedido.
+ *
+ * As alteracoes ao labirinto devem passar por setCell, que corrige os campos guardados sem
+ * os recalcular: quando uma celula fica livre, as distancias que diminuem propagam-se a
+ * partir dela; quando fica parede, primeiro marcam-se as celulas que so tinham caminhos
+ * minimos atraves dela (por ordem crescente de distancia), e so essas sao recalculadas a
+ * partir da sua fronteira. O trabalho e proporcional a regiao cujas distancias mudam.
+ */
+class MazeDistances {
+	Labirinth &lab;
+	unordered_map<uint32_t, unique_ptr<DistanceField> > goalFields;
+	unique_ptr<DistanceField> nearestField;
+
+public:
+	MazeDistances(Labirinth &lab);
+
+	/**
+	 * Campo de distancias ate a celula objectivo (goalX, goalY).
+	 * Lanca invalid_argument se a celula nao for um objectivo.
+	 * A referencia e valida enquanto o MazeDistances existir.
+	 */
+	const DistanceField& toGoal(int goalX, int goalY);
+
+	/**
+	 * Campo de distancias ate ao objectivo mais proximo.
+	 */
+	const DistanceField& toNearestGoal();
+
+	/**
+	 * Altera uma celula do labirinto (como Labirinth::setCell) e corrige os campos guardados.
+	 */
+	void setCell(int x, int y, int value);
+
+	/**
+	 * Numero de campos guardados.
+	 */
+	size_t getFieldCount() const { return goalFields.size() + (nearestField ? 1 : 0); }
+};
+
+#endif /* MAZEDISTANCES_H_ */
@@ -0,0 +1,221 @@
+/*
+ * MazeFloodFill.cpp
+ *
+ */
+
+#include "MazeFloodFill.h"
+
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+MazeFloodFill::MazeFloodFill(const Labirinth &lab)
+	: width(lab.getWidth()), height(lab.getHeight()), stride(((width + 63) / 64 + 3) / 4 * 4),
+	  freeBits(stride * height, 0), goalBits(stride * height, 0), reached(stride * height, 0),
+	  queued(height, false)
+{
+	for (int y = 0; y < height; y++) {
+		lab.getFreeBits(y, &freeBits[y * stride]);
+		lab.getGoalBits(y, &goalBits[y * stride]);
+	}
+}
+
+/* Preenchimento dentro de uma palavra, para bits mais altos (x crescente) e mais baixos,
+ * so atraves de bits de p. */
+static inline uint64_t fillUp(uint64_t g, uint64_t p)
+{
+	g |= p & (g << 1);
+	p &= p << 1;
+	g |= p & (g << 2);
+	p &= p << 2;
+	g |= p & (g << 4);
+	p &= p << 4;
+	g |= p & (g << 8);
+	p &= p << 8;
+	g |= p & (g << 16);
+	p &= p << 16;
+	return g | (p & (g << 32));
+}
+
+static inline uint64_t fillDown(uint64_t g, uint64_t p)
+{
+	g |= p & (g >> 1);
+	p &= p >> 1;
+	g |= p & (g >> 2);
+	p &= p >> 2;
+	g |= p & (g >> 4);
+	p &= p >> 4;
+	g |= p & (g >> 8);
+	p &= p >> 8;
+	g |= p & (g >> 16);
+	p &= p >> 16;
+	return g | (p & (g >> 32));
+}
+
+#ifdef __AVX2__
+static inline __m256i fillUp256(__m256i g, __m256i p)
+{
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 1)));
+	p = _mm256_and_si256(p, _mm256_slli_epi64(p, 1));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 2)));
+	p = _mm256_and_si256(p, _mm256_slli_epi64(p, 2));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 4)));
+	p = _mm256_and_si256(p, _mm256_slli_epi64(p, 4));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 8)));
+	p = _mm256_and_si256(p, _mm256_slli_epi64(p, 8));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 16)));
+	p = _mm256_and_si256(p, _mm256_slli_epi64(p, 16));
+	return _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 32)));
+}
+
+static inline __m256i fillDown256(__m256i g, __m256i p)
+{
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 1)));
+	p = _mm256_and_si256(p, _mm256_srli_epi64(p, 1));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 2)));
+	p = _mm256_and_si256(p, _mm256_srli_epi64(p, 2));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 4)));
+	p = _mm256_and_si256(p, _mm256_srli_epi64(p, 4));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 8)));
+	p = _mm256_and_si256(p, _mm256_srli_epi64(p, 8));
+	g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 16)));
+	p = _mm256_and_si256(p, _mm256_srli_epi64(p, 16));
+	return _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 32)));
+}
+#endif
+
+/* Completa a linha y ao longo das sequencias de celulas livres que ja tem celulas alcancadas. */
+void MazeFloodFill::fillRow(int y)
+{
+	uint64_t *r = &reached[y * stride];
+	const uint64_t *f = &freeBits[y * stride];
+
+	// dentro de cada palavra, nos dois sentidos
+#ifdef __AVX2__
+	for (size_t i = 0; i < stride; i += 4) {
+		__m256i g = _mm256_loadu_si256((const __m256i*) (r + i));
+		__m256i p = _mm256_loadu_si256((const __m256i*) (f + i));
+		g = fillDown256(fillUp256(g, p), p);
+		_mm256_storeu_si256((__m256i*) (r + i), g);
+	}
+#else
+	for (size_t i = 0; i < stride; i++)
+		r[i] = fillDown(fillUp(r[i], f[i]), f[i]);
+#endif
+
+	// transporte entre palavras: para a direita e depois para a esquerda
+	for (size_t i = 0; i + 1 < stride; i++)
+		if ((r[i] >> 63) & f[i + 1] & ~r[i + 1] & 1)
+			r[i + 1] = fillUp(r[i + 1] | 1, f[i + 1]);
+	for (size_t i = stride - 1; i > 0; i--)
+		if ((r[i] & 1) && ((f[i - 1] & ~r[i - 1]) >> 63))
+			r[i - 1] = fillDown(r[i - 1] | (1ULL << 63), f[i - 1]);
+}
+
+/* Junta a linha y as celulas livres por baixo ou por cima de celulas alcancadas.
+ * Devolve true se a linha mudou (ja completada com fillRow). */
+bool MazeFloodFill::growRow(int y)
+{
+	uint64_t *r = &reached[y * stride];
+	const uint64_t *f = &freeBits[y * stride];
+	const uint64_t *up = y > 0 ? r - stride : NULL;
+	const uint64_t *down = y + 1 < height ? r + stride : NULL;
+	bool changed = false;
+
+#ifdef __AVX2__
+	for (size_t i = 0; i < stride; i += 4) {
+		__m256i n = _mm256_setzero_si256();
+		if (up)
+			n = _mm256_loadu_si256((const __m256i*) (up + i));
+		if (down)
+			n = _mm256_or_si256(n, _mm256_loadu_si256((const __m256i*) (down + i)));
+		__m256i cur = _mm256_loadu_si256((const __m256i*) (r + i));
+		n = _mm256_andnot_si256(cur, _mm256_and_si256(n, _mm256_loadu_si256((const __m256i*) (f + i))));
+		if (!_mm256_testz_si256(n, n)) {
+			_mm256_storeu_si256((__m256i*) (r + i), _mm256_or_si256(cur, n));
+			changed = true;
+		}
+	}
+#else
+	for (size_t i = 0; i < stride; i++) {
+		uint64_t n = ((up ? up[i] : 0) | (down ? down[i] : 0)) & f[i] & ~r[i];
+		if (n != 0) {
+			r[i] |= n;
+			changed = true;
+		}
+	}
+#endif
+
+	if (changed)
+		fillRow(y);
+	return changed;
+}
+
+bool MazeFloodFill::flood(int x, int y, bool stopAtGoal)
+{
+	std::fill(reached.begin(), reached.end(), 0);
+	if (x < 0 || y < 0 || x >= width || y >= height || !((freeBits[y * stride + (x >> 6)] >> (x & 63)) & 1))
+		return false;
+
+	auto hasGoal = [this](int row) {
+		for (size_t i = 0; i < stride; i++)
+			if (reached[row * stride + i] & goalBits[row * stride + i])
+				return true;
+		return false;
+	};
+
+	reached[y * stride + (x >> 6)] |= 1ULL << (x & 63);
+	fillRow(y);
+	if (stopAtGoal && hasGoal(y))
+		return true;
+
+	// fila circular de linhas a rever
+	queue.assign(height, 0);
+	size_t head = 0, size = 0;
+	auto push = [&](int row) {
+		if (row >= 0 && row < height && !queued[row]) {
+			queued[row] = true;
+			queue[(head + size++) % height] = row;
+		}
+	};
+	push(y - 1);
+	push(y + 1);
+	bool found = false;
+	while (size > 0) {
+		int row = queue[head];
+		head = (head + 1) % height;
+		size--;
+		queued[row] = false;
+		if (!growRow(row))
+			continue;
+		if (stopAtGoal && hasGoal(row)) {
+			found = true;
+			break;
+		}
+		push(row - 1);
+		push(row + 1);
+	}
+	for (; size > 0; size--, head = (head + 1) % height)
+		queued[queue[head]] = false;
+	return stopAtGoal ? found : true;
+}
+
+bool MazeFloodFill::fill(int x, int y)
+{
+	return flood(x, y, false);
+}
+
+bool MazeFloodFill::findGoal(int x, int y)
+{
+	return flood(x, y, true);
+}
+
+size_t MazeFloodFill::getReachedCount() const
+{
+	size_t count = 0;
+	for (uint64_t w : reached)
+		count += __builtin_popcountll(w);
+	return count;
+}
@@ -0,0 +1,67 @@
+/*
+ * MazeFloodFill.h
+ *
+ */
+
+#ifndef MAZEFLOODFILL_H_
+#define MAZEFLOODFILL_H_
+
+#include "Labirinth.h"
+
+/**
+ * Conjunto de celulas alcancaveis a partir de uma celula, calculado 64 celulas de cada vez.
+ *
+ * Cada linha e um bitset (celulas livres e celulas alcancadas). Uma linha alcancada cresce
+ * com as linhas vizinhas (OR das linhas de cima e de baixo, AND com as celulas livres) e
+ * depois ao longo das sequencias de celulas livres (preenchimento Kogge-Stone dentro de
+ * cada palavra, com o transporte entre palavras feito a parte). As linhas que mudam poem
+ * as vizinhas numa fila, ate nada mudar. Com AVX2 as linhas sao tratadas 256 bits de cada vez.
+ *
+ * As celulas correspondem ao labirinto no momento da construcao.
+ */
+class MazeFloodFill {
+	int width, height;
+	size_t stride;                // palavras por linha (multiplo de 4)
+	vector<uint64_t> freeBits;    // celulas livres
+	vector<uint64_t> goalBits;    // celulas objectivo
+	vector<uint64_t> reached;     // celulas alcancadas pelo ultimo fill
+	vector<int> queue;
+	vector<bool> queued;
+
+	void fillRow(int y);
+	bool growRow(int y);
+	bool flood(int x, int y, bool stopAtGoal);
+
+public:
+	MazeFloodFill(const Labirinth &lab);
+
+	/**
+	 * Calcula todas as celulas alcancaveis a partir de (x, y).
+	 * Devolve false (e um conjunto vazio) se (x, y) for uma parede.
+	 */
+	bool fill(int x, int y);
+
+	/**
+	 * Indica se de (x, y) se chega a alguma celula objectivo. Para assim que chegar a uma,
+	 * por isso o conjunto alcancado fica incompleto.
+	 */
+	bool findGoal(int x, int y);
+
+	bool isReached(int x, int y) const {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return false;
+		return (reached[y * stride + (x >> 6)] >> (x & 63)) & 1;
+	}
+
+	/**
+	 * Numero de celulas alcancadas.
+	 */
+	size_t getReachedCount() const;
+
+	/**
+	 * Linha y do conjunto alcancado (bit x da palavra x / 64).
+	 */
+	const uint64_t* getReachedRow(int y) const { return reached.data() + y * stride; }
+};
+
+#endif /* MAZEFLOODFILL_H_ */
@@ -0,0 +1,202 @@
+/*
+ * MazeGenerator.cpp
+ *
+ */
+
+#include "MazeGenerator.h"
+
+#include <stdexcept>
+
+/* splitmix64: rapido e igual em todas as plataformas (ao contrario das distribuicoes de <random>). */
+struct MazeRandom {
+	uint64_t state;
+
+	MazeRandom(unsigned long long seed) : state(seed) {}
+
+	uint64_t next() {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	/* Inteiro em [0, n). */
+	uint32_t below(uint32_t n) { return (uint32_t) (((next() >> 32) * n) >> 32); }
+};
+
+static void checkSize(int width, int height)
+{
+	if (width < 1 || height < 1)
+		throw invalid_argument("MazeGenerator: size must be positive");
+	if ((unsigned long long) width * height >= UINT32_MAX)
+		throw invalid_argument("MazeGenerator: maze too large (2^32 cells or more)");
+}
+
+/* Sala i da grelha de salas de um labirinto perfeito (cw salas por linha). */
+static void openRoom(Labirinth &lab, uint32_t room, int cw)
+{
+	lab.setCell(room % cw * 2, room / cw * 2, Labirinth::FREE);
+}
+
+/* Passagem entre a sala room e a vizinha na direccao dir (0 = direita, 1 = baixo). */
+static void openPassage(Labirinth &lab, uint32_t room, int dir, int cw)
+{
+	int x = room % cw * 2, y = room / cw * 2;
+	lab.setCell(x + (dir == 0), y + (dir == 1), Labirinth::FREE);
+}
+
+static uint32_t findRoot(vector<uint32_t> &parent, uint32_t x)
+{
+	while (parent[x] != x) {
+		parent[x] = parent[parent[x]];
+		x = parent[x];
+	}
+	return x;
+}
+
+Labirinth MazeGenerator::kruskal(int width, int height, unsigned long long seed)
+{
+	checkSize(width, height);
+	Labirinth lab(width, height);
+	int cw = (width + 1) / 2, ch = (height + 1) / 2;
+	uint32_t rooms = (uint32_t) cw * ch;
+	MazeRandom random(seed);
+
+	// paredes entre salas (sala * 2 + direccao), por ordem aleatoria
+	vector<uint32_t> edges;
+	edges.reserve(2 * (size_t) rooms);
+	for (uint32_t r = 0; r < rooms; r++) {
+		openRoom(lab, r, cw);
+		if ((int) (r % cw) + 1 < cw)
+			edges.push_back(r * 2);
+		if ((int) (r / cw) + 1 < ch)
+			edges.push_back(r * 2 + 1);
+	}
+	for (size_t i = edges.size(); i > 1; i--)
+		swap(edges[i - 1], edges[random.below(i)]);
+
+	// cada parede entre duas arvores diferentes e aberta
+	vector<uint32_t> parent(rooms);
+	for (uint32_t r = 0; r < rooms; r++)
+		parent[r] = r;
+	uint32_t joins = 0;
+	for (uint32_t e : edges) {
+		uint32_t r = e >> 1, dir = e & 1;
+		uint32_t a = findRoot(parent, r), b = findRoot(parent, dir == 0 ? r + 1 : r + cw);
+		if (a == b)
+			continue;
+		parent[a] = b;
+		openPassage(lab, r, dir, cw);
+		if (++joins + 1 == rooms)
+			break;
+	}
+	return lab;
+}
+
+Labirinth MazeGenerator::wilson(int width, int height, unsigned long long seed)
+{
+	checkSize(width, height);
+	Labirinth lab(width, height);
+	int cw = (width + 1) / 2, ch = (height + 1) / 2;
+	uint32_t rooms = (uint32_t) cw * ch;
+	MazeRandom random(seed);
+	static const int DX[4] = { 1, 0, -1, 0 };
+	static const int DY[4] = { 0, 1, 0, -1 };
+
+	vector<bool> inTree(rooms, false);
+	vector<uint8_t> exit(rooms);          // ultima direccao tomada a partir de cada sala
+	uint32_t root = random.below(rooms);
+	inTree[root] = true;
+	openRoom(lab, root, cw);
+
+	for (uint32_t start = 0; start < rooms; start++) {
+		// passeio ate a arvore; voltar a uma sala apaga o ciclo (a direccao e reescrita)
+		uint32_t r = start;
+		while (!inTree[r]) {
+			int x = r % cw, y = r / cw, d;
+			do
+				d = random.below(4);
+			while (x + DX[d] < 0 || x + DX[d] >= cw || y + DY[d] < 0 || y + DY[d] >= ch);
+			exit[r] = d;
+			r = (y + DY[d]) * cw + x + DX[d];
+		}
+		// o caminho sem ciclos passa a fazer parte da arvore
+		for (r = start; !inTree[r]; ) {
+			int x = r % cw, y = r / cw, d = exit[r];
+			inTree[r] = true;
+			openRoom(lab, r, cw);
+			lab.setCell(x * 2 + DX[d], y * 2 + DY[d], Labirinth::FREE);
+			r = (y + DY[d]) * cw + x + DX[d];
+		}
+	}
+	return lab;
+}
+
+Labirinth MazeGenerator::caves(int width, int height, unsigned long long seed, int wallPercent, int iterations)
+{
+	checkSize(width, height);
+	MazeRandom random(seed);
+	size_t w = width;
+	vector<uint8_t> wall(w * height), next(w * height);
+	for (uint8_t &c : wall)
+		c = random.below(100) < (uint32_t) wallPercent;
+
+	for (int it = 0; it < iterations; it++) {
+		for (int y = 0; y < height; y++)
+			for (int x = 0; x < width; x++) {
+				int walls = 0;
+				for (int dy = -1; dy <= 1; dy++)
+					for (int dx = -1; dx <= 1; dx++) {
+						int nx = x + dx, ny = y + dy;
+						walls += nx < 0 || ny < 0 || nx >= width || ny >= height || wall[ny * w + nx];
+					}
+				next[y * w + x] = walls >= 5;
+			}
+		wall.swap(next);
+	}
+
+	Labirinth lab(width, height);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (!wall[y * w + x])
+				lab.setCell(x, y, Labirinth::FREE);
+	return lab;
+}
+
+Labirinth MazeGenerator::rooms(int width, int height, unsigned long long seed, int roomSize)
+{
+	checkSize(width, height);
+	if (roomSize < 3)
+		throw invalid_argument("MazeGenerator: rooms must be at least 3x3");
+	MazeRandom random(seed);
+	Labirinth lab(width, height);
+
+	// a ultima coluna e a ultima linha de cada sala sao parede
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (x % roomSize != roomSize - 1 && y % roomSize != roomSize - 1)
+				lab.setCell(x, y, Labirinth::FREE);
+
+	// uma porta em cada parede entre duas salas: ocupa entre 1 e (roomSize - 1) / 2 celulas
+	int inner = roomSize - 1;
+	for (int ry = 0; ry * roomSize < height; ry++)
+		for (int rx = 0; rx * roomSize < width; rx++) {
+			int x0 = rx * roomSize, y0 = ry * roomSize;
+			int wallX = x0 + inner, wallY = y0 + inner;
+			if (wallX + 1 < width) {
+				int span = min(inner, height - y0);
+				int door = 1 + random.below(max(1, inner / 2));
+				int at = y0 + random.below(max(1, span - door + 1));
+				for (int y = at; y < at + door && y < y0 + span; y++)
+					lab.setCell(wallX, y, Labirinth::FREE);
+			}
+			if (wallY + 1 < height) {
+				int span = min(inner, width - x0);
+				int door = 1 + random.below(max(1, inner / 2));
+				int at = x0 + random.below(max(1, span - door + 1));
+				for (int x = at; x < at + door && x < x0 + span; x++)
+					lab.setCell(x, wallY, Labirinth::FREE);
+			}
+		}
+	return lab;
+}
@@ -0,0 +1,46 @@
+/*
+ * MazeGenerator.h
+ *
+ */
+
+#ifndef MAZEGENERATOR_H_
+#define MAZEGENERATOR_H_
+
+#include "Labirinth.h"
+
+/**
+ * Geradores de labirintos grandes, deterministas: a mesma semente da sempre o mesmo
+ * labirinto, em qualquer plataforma (o gerador de numeros aleatorios e proprio).
+ * Os labirintos gerados so tem paredes e celulas livres; os objectivos ficam a cargo de quem usa.
+ */
+class MazeGenerator {
+public:
+	/**
+	 * Labirinto perfeito (uma arvore: exactamente um caminho entre duas celulas livres) pelo
+	 * algoritmo de Kruskal aleatorio. As salas ficam nas coordenadas pares e as passagens entre
+	 * elas nas impares; com largura ou altura par, a ultima coluna ou linha fica toda parede.
+	 */
+	static Labirinth kruskal(int width, int height, unsigned long long seed);
+
+	/**
+	 * Labirinto perfeito pelo algoritmo de Wilson (passeios aleatorios com os ciclos apagados),
+	 * que escolhe uniformemente entre todas as arvores. Mesma disposicao que kruskal; mais
+	 * lento nos labirintos grandes, porque os primeiros passeios sao longos.
+	 */
+	static Labirinth wilson(int width, int height, unsigned long long seed);
+
+	/**
+	 * Grutas por automato celular: cada celula comeca parede com probabilidade wallPercent %
+	 * e, em cada iteracao, fica parede se tiver 5 ou mais paredes entre ela e as 8 vizinhas
+	 * (fora do labirinto conta como parede). Pode haver zonas desligadas.
+	 */
+	static Labirinth caves(int width, int height, unsigned long long seed, int wallPercent = 45, int iterations = 4);
+
+	/**
+	 * Salas abertas de roomSize x roomSize celulas (paredes incluidas), cada uma ligada as
+	 * vizinhas por uma porta de largura aleatoria numa posicao aleatoria. Tudo fica ligado.
+	 */
+	static Labirinth rooms(int width, int height, unsigned long long seed, int roomSize = 16);
+};
+
+#endif /* MAZEGENERATOR_H_ */
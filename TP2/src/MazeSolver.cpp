@@ -0,0 +1,433 @@
+/*
+ * MazeSolver.cpp
+ *
+ */
+
+#include "MazeSolver.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+MazePath::MazePath() : startX(0), startY(0), length(0)
+{
+}
+
+void MazePath::clear(int x, int y)
+{
+	startX = x;
+	startY = y;
+	moves.clear();
+	length = 0;
+}
+
+void MazePath::push_back(Direction d)
+{
+	if ((length & 3) == 0)
+		moves.push_back(0);
+	moves.back() |= d << ((length & 3) * 2);
+	length++;
+}
+
+pair<int,int> MazePath::getEnd() const
+{
+	int x = startX, y = startY;
+	for (size_t i = 0; i < length; i++) {
+		x += DIRECTION_DX[(*this)[i]];
+		y += DIRECTION_DY[(*this)[i]];
+	}
+	return make_pair(x, y);
+}
+
+string MazePath::toString() const
+{
+	static const char names[4] = { 'R', 'D', 'L', 'U' };
+	string res(length, ' ');
+	for (size_t i = 0; i < length; i++)
+		res[i] = names[(*this)[i]];
+	return res;
+}
+
+
+MazeSolver::MazeSolver(const Labirinth &lab)
+	: lab(lab), width(lab.getWidth()), height(lab.getHeight()), expanded(0)
+{
+	size_t cells = (size_t) width * height;
+	if (cells >= UINT32_MAX)
+		throw invalid_argument("MazeSolver: maze too large (2^32 cells or more)");
+	visited.assign((cells + 63) / 64, 0);
+	parent.assign((cells + 3) / 4, 0);
+}
+
+void MazeSolver::visit(uint32_t cell, int from)
+{
+	visited[cell >> 6] |= 1ULL << (cell & 63);
+	uint8_t &p = parent[cell >> 2];
+	int shift = (cell & 3) * 2;
+	p = (p & ~(3 << shift)) | (from << shift);
+	touched.push_back(cell);
+}
+
+void MazeSolver::reset()
+{
+	for (uint32_t cell : touched)
+		visited[cell >> 6] &= ~(1ULL << (cell & 63));
+	if (!jumpClosed.empty())
+		for (uint32_t cell : touched)
+			jumpClosed[cell >> 1] = 0;
+	for (uint32_t row : jumpRows)
+		jumpRowReady[row] = 0;
+	jumpRows.clear();
+	for (uint32_t cell : touchedBack)
+		visitedBack[cell >> 6] &= ~(1ULL << (cell & 63));
+	touched.clear();
+	touchedBack.clear();
+	heap.clear();
+	jumpHeap.clear();
+	jumpParent.clear();
+	expanded = 0;
+}
+
+/* Prepara uma nova pesquisa; devolve false se a partida for uma parede. */
+bool MazeSolver::startSearch(int x, int y, MazePath &path)
+{
+	reset();
+	path.clear(x, y);
+	return lab.getCell(x, y) != Labirinth::WALL;
+}
+
+bool MazeSolver::findGoal(int x, int y, MazePath &path)
+{
+	const Labirinth &l = lab;
+	int w = width;
+	return bfs(x, y, [&l, w](uint32_t cell) { return l.getCell(cell % w, cell / w) == Labirinth::GOAL; }, path);
+}
+
+bool MazeSolver::findPath(int x, int y, int goalX, int goalY, MazePath &path, Algorithm algorithm)
+{
+	if (lab.getCell(goalX, goalY) == Labirinth::WALL) {
+		reset();
+		path.clear(x, y);
+		return false;
+	}
+	if (algorithm == ASTAR)
+		return astar(x, y, goalX, goalY, path);
+	if (algorithm == JPS)
+		return jps(x, y, goalX, goalY, path);
+	if (algorithm == BIDIRECTIONAL)
+		return bidirectional(x, y, goalX, goalY, path);
+	uint32_t target = (uint32_t) goalY * width + goalX;
+	return bfs(x, y, [target](uint32_t cell) { return cell == target; }, path);
+}
+
+/* BFS a partir de (x, y) ate a primeira celula que satisfaz isTarget; a fila e o
+ * proprio vector touched (as celulas nunca saem dele ate a proxima pesquisa). */
+template <class IsTarget>
+bool MazeSolver::bfs(int x, int y, IsTarget isTarget, MazePath &path)
+{
+	if (!startSearch(x, y, path))
+		return false;
+	uint32_t start = (uint32_t) y * width + x;
+	visit(start, 0);
+	if (isTarget(start))
+		return true;
+
+	for (size_t head = 0; head < touched.size(); head++) {
+		uint32_t cell = touched[head];
+		int cx = cell % width, cy = cell / width;
+		expanded++;
+		for (int d = 0; d < 4; d++) {
+			int nx = cx + DIRECTION_DX[d], ny = cy + DIRECTION_DY[d];
+			if (lab.getCell(nx, ny) == Labirinth::WALL)
+				continue;
+			uint32_t next = (uint32_t) ny * width + nx;
+			if (isVisited(next))
+				continue;
+			visit(next, d);
+			if (isTarget(next)) {
+				buildPath(next, path);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* A* com heuristica de Manhattan (consistente): a primeira vez que uma celula sai do heap
+ * tem a distancia minima, por isso as celulas so sao marcadas nesse momento e o heap pode
+ * ter entradas repetidas (no maximo 4 por celula). Em caso de empate em f sai primeiro a
+ * entrada com maior g, a mais proxima do destino. */
+bool MazeSolver::astar(int x, int y, int goalX, int goalY, MazePath &path)
+{
+	if (!startSearch(x, y, path))
+		return false;
+	uint32_t target = (uint32_t) goalY * width + goalX;
+	HeapEntry first = { (uint32_t) (abs(goalX - x) + abs(goalY - y)), 0, (uint32_t) y * width + x, 0 };
+	heap.push_back(first);
+
+	while (!heap.empty()) {
+		pop_heap(heap.begin(), heap.end());
+		HeapEntry e = heap.back();
+		heap.pop_back();
+		if (isVisited(e.cell))
+			continue;
+		visit(e.cell, e.from);
+		expanded++;
+		if (e.cell == target) {
+			buildPath(e.cell, path);
+			return true;
+		}
+		int cx = e.cell % width, cy = e.cell / width;
+		for (int d = 0; d < 4; d++) {
+			int nx = cx + DIRECTION_DX[d], ny = cy + DIRECTION_DY[d];
+			if (lab.getCell(nx, ny) == Labirinth::WALL)
+				continue;
+			uint32_t next = (uint32_t) ny * width + nx;
+			if (isVisited(next))
+				continue;
+			HeapEntry n = { e.g + 1 + abs(goalX - nx) + abs(goalY - ny), e.g + 1, next, (uint32_t) d };
+			heap.push_back(n);
+			push_heap(heap.begin(), heap.end());
+		}
+	}
+	return false;
+}
+
+/* Reconstroi o caminho ate cell seguindo as direccoes de chegada ate a partida. */
+void MazeSolver::buildPath(uint32_t cell, MazePath &path)
+{
+	uint32_t start = (uint32_t) path.getStartY() * width + path.getStartX();
+	reversed.clear();
+	while (cell != start) {
+		int d = (parent[cell >> 2] >> ((cell & 3) * 2)) & 3;
+		reversed.push_back(d);
+		int x = cell % width - DIRECTION_DX[d], y = cell / width - DIRECTION_DY[d];
+		cell = (uint32_t) y * width + x;
+	}
+	for (size_t i = reversed.size(); i > 0; i--)
+		path.push_back((Direction) reversed[i - 1]);
+}
+
+/* BFS dos dois lados, uma camada completa de cada vez, sempre do lado com a fronteira
+ * mais pequena. Se antes de uma camada os dois conjuntos de visitadas sao disjuntos
+ * (distancias ate k de um lado e ate j do outro), qualquer caminho tem pelo menos
+ * k + j + 1 passos; o primeiro encontro tem exactamente esse comprimento. */
+bool MazeSolver::bidirectional(int x, int y, int goalX, int goalY, MazePath &path)
+{
+	if (!startSearch(x, y, path))
+		return false;
+	if (visitedBack.empty()) {
+		visitedBack.assign(visited.size(), 0);
+		parentBack.assign(parent.size(), 0);
+	}
+	uint32_t start = (uint32_t) y * width + x, target = (uint32_t) goalY * width + goalX;
+	visit(start, 0);
+	if (start == target)
+		return true;
+	visitedBack[target >> 6] |= 1ULL << (target & 63);
+	touchedBack.push_back(target);
+
+	size_t headForward = 0, headBack = 0;
+	while (headForward < touched.size() && headBack < touchedBack.size()) {
+		bool forward = touched.size() - headForward <= touchedBack.size() - headBack;
+		vector<uint32_t> &queue = forward ? touched : touchedBack;
+		vector<uint64_t> &own = forward ? visited : visitedBack;
+		vector<uint64_t> &other = forward ? visitedBack : visited;
+		vector<uint8_t> &ownParent = forward ? parent : parentBack;
+		size_t &head = forward ? headForward : headBack;
+
+		for (size_t layerEnd = queue.size(); head < layerEnd; head++) {
+			uint32_t cell = queue[head];
+			int cx = cell % width, cy = cell / width;
+			expanded++;
+			for (int d = 0; d < 4; d++) {
+				int nx = cx + DIRECTION_DX[d], ny = cy + DIRECTION_DY[d];
+				if (!isFree(nx, ny))
+					continue;
+				uint32_t next = (uint32_t) ny * width + nx;
+				if ((own[next >> 6] >> (next & 63)) & 1)
+					continue;
+				if ((other[next >> 6] >> (next & 63)) & 1) {
+					// encontro: partida -> meet, um passo, e depois o lado do destino ate ao fim
+					uint32_t meet = forward ? cell : next, back = forward ? next : cell;
+					int step = forward ? d : (d + 2) & 3;
+					buildPath(meet, path);
+					path.push_back((Direction) step);
+					while (back != target) {
+						int away = ((parentBack[back >> 2] >> ((back & 3) * 2)) & 3) ^ 2;
+						path.push_back((Direction) away);
+						back = (uint32_t) (back / width + DIRECTION_DY[away]) * width + back % width + DIRECTION_DX[away];
+					}
+					return true;
+				}
+				own[next >> 6] |= 1ULL << (next & 63);
+				uint8_t &p = ownParent[next >> 2];
+				int shift = (next & 3) * 2;
+				p = (p & ~(3 << shift)) | (d << shift);
+				queue.push_back(next);
+			}
+		}
+	}
+	return false;
+}
+
+/* Salto horizontal a partir de (x, y): primeira celula que e o destino ou em que a celula
+ * acima ou abaixo e livre e a anterior na diagonal para tras e parede. -1 se bater numa parede. */
+int MazeSolver::jumpHorizontal(int x, int y, int dx, int goalX, int goalY) const
+{
+	for (;;) {
+		x += dx;
+		if (!isFree(x, y))
+			return -1;
+		if (x == goalX && y == goalY)
+			return x;
+		if ((isFree(x, y - 1) && !isFree(x - dx, y - 1)) || (isFree(x, y + 1) && !isFree(x - dx, y + 1)))
+			return x;
+	}
+}
+
+/* Salto vertical: para no destino ou numa celula de onde um salto horizontal chega a algum lado,
+ * isto e, com o destino no mesmo troco livre da linha ou com o bit de jumpStops marcado. */
+int MazeSolver::jumpVertical(int x, int y, int dy)
+{
+	for (;;) {
+		y += dy;
+		if (!isFree(x, y))
+			return -1;
+		if (y == jumpGoalY && x >= jumpGoalLo && x <= jumpGoalHi)
+			return y;
+		if (!jumpRowReady[y])
+			computeJumpRow(y);
+		uint32_t cell = (uint32_t) y * width + x;
+		if ((jumpStops[cell >> 6] >> (cell & 63)) & 1)
+			return y;
+	}
+}
+
+/* jumpStops da linha y, em duas passagens: uma celula e marcada se houver, no seu troco livre,
+ * uma celula forcada para a esquerda antes dela ou uma forcada para a direita depois dela
+ * (as mesmas condicoes de jumpHorizontal). O destino e tratado a parte, em jumpVertical. */
+void MazeSolver::computeJumpRow(int y)
+{
+	jumpRowReady[y] = 1;
+	jumpRows.push_back(y);
+	uint32_t base = (uint32_t) y * width;
+	bool forced = false;
+	for (int x = 0; x < width; x++) {
+		if (!isFree(x, y)) {
+			forced = false;
+			continue;
+		}
+		uint32_t cell = base + x;
+		jumpStops[cell >> 6] = (jumpStops[cell >> 6] & ~(1ULL << (cell & 63))) | ((uint64_t) forced << (cell & 63));
+		if ((isFree(x, y - 1) && !isFree(x + 1, y - 1)) || (isFree(x, y + 1) && !isFree(x + 1, y + 1)))
+			forced = true;
+	}
+	forced = false;
+	for (int x = width - 1; x >= 0; x--) {
+		if (!isFree(x, y)) {
+			forced = false;
+			continue;
+		}
+		uint32_t cell = base + x;
+		if (forced)
+			jumpStops[cell >> 6] |= 1ULL << (cell & 63);
+		if ((isFree(x, y - 1) && !isFree(x - 1, y - 1)) || (isFree(x, y + 1) && !isFree(x - 1, y + 1)))
+			forced = true;
+	}
+}
+
+/* A* sobre pontos de salto. Todo o caminho minimo pode ser rearranjado (trocando um passo
+ * horizontal seguido de um vertical quando a celula diagonal e livre) num de igual
+ * comprimento em que cada viragem de horizontal para vertical e forcada; sao esses os
+ * caminhos seguidos. Como os sucessores dependem da direccao de chegada, os estados
+ * sao (celula, direccao). */
+bool MazeSolver::jps(int x, int y, int goalX, int goalY, MazePath &path)
+{
+	if (!startSearch(x, y, path))
+		return false;
+	if (jumpClosed.empty()) {
+		jumpClosed.assign(((size_t) width * height + 1) / 2, 0);
+		jumpStops.assign(((size_t) width * height + 63) / 64, 0);
+		jumpRowReady.assign(height, 0);
+	}
+	jumpGoalY = goalY;
+	for (jumpGoalLo = goalX; isFree(jumpGoalLo - 1, goalY); jumpGoalLo--)
+		;
+	for (jumpGoalHi = goalX; isFree(jumpGoalHi + 1, goalY); jumpGoalHi++)
+		;
+	uint32_t start = (uint32_t) y * width + x, target = (uint32_t) goalY * width + goalX;
+	if (start == target)
+		return true;
+
+	uint64_t startState = (uint64_t) start * 8 + 4;
+	JumpEntry first = { (uint32_t) (abs(goalX - x) + abs(goalY - y)), 0, startState, startState };
+	jumpHeap.push_back(first);
+	while (!jumpHeap.empty()) {
+		pop_heap(jumpHeap.begin(), jumpHeap.end());
+		JumpEntry e = jumpHeap.back();
+		jumpHeap.pop_back();
+		uint32_t cell = e.state >> 3;
+		int dir = e.state & 7;
+		if (dir < 4) {
+			uint8_t &closed = jumpClosed[cell >> 1];
+			int bit = 1 << ((cell & 1) * 4 + dir);
+			if (closed & bit)
+				continue;
+			closed |= bit;
+			touched.push_back(cell);
+		}
+		jumpParent[e.state] = e.parent;
+		expanded++;
+
+		if (cell == target) {
+			// segmentos (direccao, comprimento) do fim para o inicio
+			vector<pair<int,int> > segments;
+			for (uint64_t s = e.state; (s & 7) != 4; ) {
+				uint64_t p = jumpParent[s];
+				int from = p >> 3, to = s >> 3;
+				segments.push_back(make_pair((int) (s & 7), abs(to % width - from % width) + abs(to / width - from / width)));
+				s = p;
+			}
+			for (size_t i = segments.size(); i > 0; i--)
+				for (int k = 0; k < segments[i - 1].second; k++)
+					path.push_back((Direction) segments[i - 1].first);
+			return true;
+		}
+
+		int cx = cell % width, cy = cell / width;
+		int dirs[4], count = 0;
+		if (dir == 4) {
+			for (int d = 0; d < 4; d++)
+				dirs[count++] = d;
+		} else if (DIRECTION_DX[dir] != 0) {
+			int dx = DIRECTION_DX[dir];
+			dirs[count++] = dir;
+			for (int d : { DOWN, UP })
+				if (isFree(cx, cy + DIRECTION_DY[d]) && !isFree(cx - dx, cy + DIRECTION_DY[d]))
+					dirs[count++] = d;
+		} else {
+			dirs[count++] = dir;
+			dirs[count++] = RIGHT;
+			dirs[count++] = LEFT;
+		}
+
+		for (int i = 0; i < count; i++) {
+			int d = dirs[i], nx = cx, ny = cy;
+			if (DIRECTION_DX[d] != 0)
+				nx = jumpHorizontal(cx, cy, DIRECTION_DX[d], goalX, goalY);
+			else
+				ny = jumpVertical(cx, cy, DIRECTION_DY[d]);
+			if (nx < 0 || ny < 0)
+				continue;
+			uint32_t next = (uint32_t) ny * width + nx;
+			if ((jumpClosed[next >> 1] >> ((next & 1) * 4 + d)) & 1)
+				continue;
+			uint32_t g = e.g + abs(nx - cx) + abs(ny - cy);
+			JumpEntry n = { g + abs(goalX - nx) + abs(goalY - ny), g, (uint64_t) next * 8 + d, e.state };
+			jumpHeap.push_back(n);
+			push_heap(jumpHeap.begin(), jumpHeap.end());
+		}
+	}
+	return false;
+}
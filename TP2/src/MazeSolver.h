@@ -0,0 +1,145 @@
+/*
+ * MazeSolver.h
+ *
+ */
+
+#ifndef MAZESOLVER_H_
+#define MAZESOLVER_H_
+
+#include "Labirinth.h"
+#include <unordered_map>
+
+/**
+ * Direccoes de um passo no labirinto (x cresce para a direita, y para baixo).
+ */
+enum Direction { RIGHT = 0, DOWN = 1, LEFT = 2, UP = 3 };
+
+static const int DIRECTION_DX[4] = { 1, 0, -1, 0 };
+static const int DIRECTION_DY[4] = { 0, 1, 0, -1 };
+
+/**
+ * Caminho no labirinto: celula de partida e sequencia de passos, 2 bits por passo.
+ */
+class MazePath {
+	int startX, startY;
+	vector<uint8_t> moves;
+	size_t length;
+public:
+	MazePath();
+
+	/**
+	 * Esvazia o caminho, que passa a comecar em (x, y).
+	 */
+	void clear(int x, int y);
+	void push_back(Direction d);
+
+	size_t size() const { return length; }
+	Direction operator[](size_t i) const { return (Direction) ((moves[i >> 2] >> ((i & 3) * 2)) & 3); }
+	int getStartX() const { return startX; }
+	int getStartY() const { return startY; }
+
+	/**
+	 * Celula onde o caminho termina.
+	 */
+	pair<int,int> getEnd() const;
+
+	/**
+	 * Passos como texto, um caracter por passo: R, D, L ou U.
+	 */
+	string toString() const;
+};
+
+/**
+ * Procura de caminhos minimos (em numero de passos, 4 vizinhos) num Labirinth.
+ *
+ * Iterativo, sem recursao: a BFS usa uma fila explicita e o A* (heuristica de Manhattan)
+ * um heap binario. O estado de cada pesquisa (bitset de celulas visitadas e direccao de
+ * chegada a cada celula, 2 bits) e alocado uma vez no construtor e reaproveitado; no inicio
+ * de cada pesquisa so se limpam as celulas marcadas pela anterior, em O(visitadas).
+ *
+ * Para grelhas grandes e abertas ha ainda:
+ *  - JPS (Jump Point Search para 4 vizinhos): A* sobre pontos de salto. Entre caminhos
+ *    minimos equivalentes so se consideram os que viram de horizontal para vertical numa
+ *    celula "forcada" (em que a celula diagonal para tras e parede); os movimentos
+ *    horizontais avancam sem parar ate uma dessas celulas, e os verticais testam em cada
+ *    celula se um salto horizontal chega a algum lado (consultando um bit por celula,
+ *    calculado para a linha inteira na primeira vez que uma pesquisa la passa);
+ *  - BIDIRECTIONAL: BFS a partir da partida e do destino, expandindo sempre a fronteira
+ *    mais pequena, uma camada de cada vez.
+ * Todos dao caminhos com o comprimento minimo; getExpanded() permite comparar o trabalho.
+ *
+ * O labirinto nao deve mudar de dimensoes enquanto o MazeSolver existir.
+ */
+class MazeSolver {
+public:
+	enum Algorithm { BFS, ASTAR, JPS, BIDIRECTIONAL };
+
+	MazeSolver(const Labirinth &lab);
+
+	/**
+	 * Caminho minimo de (x, y) ate a celula objectivo (valor 2) mais proxima, por BFS.
+	 * Devolve false (e um caminho vazio) se nenhuma for alcancavel.
+	 */
+	bool findGoal(int x, int y, MazePath &path);
+
+	/**
+	 * Caminho minimo de (x, y) ate (goalX, goalY), com o algoritmo indicado.
+	 * Devolve false (e um caminho vazio) se o destino nao for alcancavel.
+	 */
+	bool findPath(int x, int y, int goalX, int goalY, MazePath &path, Algorithm algorithm = BFS);
+
+	/**
+	 * Celulas expandidas (retiradas da fila ou do heap) na ultima pesquisa;
+	 * no JPS, pontos de salto expandidos.
+	 */
+	long long getExpanded() const { return expanded; }
+
+private:
+	struct HeapEntry {
+		uint32_t f, g;      // estimativa total e distancia desde a partida
+		uint32_t cell;
+		uint32_t from;      // direccao de chegada
+		bool operator<(const HeapEntry &o) const { return f > o.f || (f == o.f && g < o.g); }
+	};
+
+	struct JumpEntry {
+		uint32_t f, g;
+		uint64_t state, parent;      // estado = celula * 8 + direccao de chegada (4 = partida)
+		bool operator<(const JumpEntry &o) const { return f > o.f || (f == o.f && g < o.g); }
+	};
+
+	const Labirinth &lab;
+	int width, height;
+	vector<uint64_t> visited;       // 1 bit por celula, indice y * width + x
+	vector<uint8_t> parent;         // direccao de chegada, 2 bits por celula
+	vector<uint32_t> touched;       // celulas marcadas (na BFS, e tambem a fila)
+	vector<HeapEntry> heap;
+	vector<uint8_t> reversed;       // passos do caminho, do fim para o inicio
+	vector<uint64_t> visitedBack;   // BIDIRECTIONAL: lado do destino (criados na 1a utilizacao)
+	vector<uint8_t> parentBack;
+	vector<uint32_t> touchedBack;
+	vector<uint8_t> jumpClosed;     // JPS: 4 bits por celula, um por direccao de chegada
+	vector<JumpEntry> jumpHeap;
+	unordered_map<uint64_t, uint64_t> jumpParent;
+	vector<uint64_t> jumpStops;     // JPS: 1 bit por celula, um salto horizontal dali para numa celula forcada
+	vector<uint8_t> jumpRowReady;   // linhas de jumpStops ja calculadas nesta pesquisa
+	vector<uint32_t> jumpRows;
+	int jumpGoalY, jumpGoalLo, jumpGoalHi;   // troco livre da linha do destino
+	long long expanded;
+
+	bool isVisited(uint32_t cell) const { return (visited[cell >> 6] >> (cell & 63)) & 1; }
+	void visit(uint32_t cell, int from);
+	void reset();
+	bool startSearch(int x, int y, MazePath &path);
+	template <class IsTarget> bool bfs(int x, int y, IsTarget isTarget, MazePath &path);
+	bool astar(int x, int y, int goalX, int goalY, MazePath &path);
+	void buildPath(uint32_t cell, MazePath &path);
+	bool bidirectional(int x, int y, int goalX, int goalY, MazePath &path);
+	bool jps(int x, int y, int goalX, int goalY, MazePath &path);
+	bool isFree(int x, int y) const { return lab.getCell(x, y) != Labirinth::WALL; }
+	int jumpHorizontal(int x, int y, int dx, int goalX, int goalY) const;
+	int jumpVertical(int x, int y, int dy);
+	void computeJumpRow(int y);
+};
+
+#endif /* MAZESOLVER_H_ */
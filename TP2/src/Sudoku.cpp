@@ -5,6 +5,8 @@
 
 #include "Sudoku.h"
 
+const uint16_t Sudoku::ALL_NUMBERS;
+
 /** Inicia um Sudoku vazio.
  */
 Sudoku::Sudoku()
@@ -30,12 +32,7 @@ Sudoku::Sudoku(int nums[9][9])
 		{
 			if (nums[i][j] != 0)
 			{
-				int n = nums[i][j];
-				numbers[i][j] = n;
-				lineHasNumber[i][n] = true;
-				columnHasNumber[j][n] = true;
-				block3x3HasNumber[i / 3][j / 3][n] = true;
-				countFilled++;
+				fillSqr(i, j, nums[i][j]);
 			}
 		}
 	}
@@ -46,18 +43,16 @@ void Sudoku::initialize()
 	for (int i = 0; i < 9; i++)
 	{
 		for (int j = 0; j < 9; j++)
-		{
-			for (int n = 0; n < 10; n++)
-			{
-				numbers[i][j] = 0;
-				lineHasNumber[i][n] = false;
-				columnHasNumber[j][n] = false;
-				block3x3HasNumber[i / 3][j / 3][n] = false;
-			}
-		}
+			numbers[i][j] = 0;
+
+		lineMask[i] = 0;
+		columnMask[i] = 0;
+		blockMask[i] = 0;
 	}
 
 	this->countFilled = 0;
+	this->trailSize = 0;
+	this->searchNodes = 0;
 }
 
 /**
@@ -94,69 +89,152 @@ bool Sudoku::isComplete()
  */
 bool Sudoku::solve()
 {
-	return solve(0,0);
+	// as casas preenchidas por um solve anterior ja nao se desfazem pelo registo
+	trailSize = 0;
+	searchNodes = 0;
+	return solveNext();
 }
 
+/* Preenche uma casa durante a pesquisa, registando-a para poder ser desfeita. */
+void Sudoku::assign(int i, int j, int n)
+{
+	fillSqr(i, j, n);
+	trail[trailSize++] = i * 9 + j;
+}
 
+/* Desfaz as casas preenchidas depois da marca (um valor anterior de trailSize). */
+void Sudoku::undo(int mark)
+{
+	while (trailSize > mark) {
+		int cell = trail[--trailSize];
+		unFillSqr(cell / 9, cell % 9, numbers[cell / 9][cell % 9]);
+	}
+}
 
-bool Sudoku::solve(int i, int j) {
-
-	if(isComplete() || i > 8 || j>8)
-		return true;
-
-	pair<int,int> sqr;
+/**
+ * Jogadas forcadas ate nao haver mais: casas com um so candidato (naked singles) e numeros
+ * com uma so casa possivel numa linha, coluna ou bloco (hidden singles).
+ * Devolve false se encontrar uma contradicao (casa sem candidatos ou numero sem lugar).
+ */
+bool Sudoku::propagate()
+{
+	bool changed = true;
+	while (changed && !isComplete()) {
+		changed = false;
+
+		for (int i = 0; i < 9; i++)
+			for (int j = 0; j < 9; j++) {
+				if (numbers[i][j] != 0)
+					continue;
+				uint16_t cand = candidates(i, j);
+				if (cand == 0)
+					return false;
+				if ((cand & (cand - 1)) == 0) {
+					assign(i, j, __builtin_ctz(cand));
+					changed = true;
+				}
+			}
 
-	//verificar quando est preenchido
-	if(numbers[i][j] !=0) {
-		if(i ==8 && j ==8) {
-			return true;
+		// unidade u: linhas 0-8, colunas 9-17, blocos 18-26; casa k da unidade em (i, j)
+		for (int u = 0; u < 27; u++) {
+			uint16_t once = 0, twice = 0, used;
+			int cells[9][2];
+			for (int k = 0; k < 9; k++) {
+				int i = u < 9 ? u : u < 18 ? k : (u - 18) / 3 * 3 + k / 3;
+				int j = u < 9 ? k : u < 18 ? u - 9 : (u - 18) % 3 * 3 + k % 3;
+				cells[k][0] = i;
+				cells[k][1] = j;
+				if (numbers[i][j] == 0) {
+					uint16_t cand = candidates(i, j);
+					twice |= once & cand;
+					once |= cand;
+				}
+			}
+			used = u < 9 ? lineMask[u] : u < 18 ? columnMask[u - 9] : blockMask[u - 18];
+			if ((once | used) != ALL_NUMBERS)
+				return false;
+			for (uint16_t hidden = once & ~twice; hidden != 0; hidden &= hidden - 1) {
+				int n = __builtin_ctz(hidden);
+				for (int k = 0; k < 9; k++) {
+					int i = cells[k][0], j = cells[k][1];
+					// uma jogada anterior desta unidade pode ja ter ocupado a casa ou o numero
+					if (numbers[i][j] == 0 && (candidates(i, j) >> n & 1)) {
+						assign(i, j, n);
+						changed = true;
+						break;
+					}
+				}
+			}
 		}
-		//continuar para a proxima casa
-		sqr = nextSquare(i,j);
-		return solve(sqr.first,sqr.second);
 	}
+	return true;
+}
 
-	//tentar preencher o quadrado com um numero 1..9
-	for(int n =1; n<=9;n++) {
-		//verificar as condicoes de jogo
-		if(block3x3HasNumber[i/3][j/3][n] || columnHasNumber[j][n] || lineHasNumber[i][n])
-			continue;
-		else {
-			//preencher o quadrado
-			fillSqr(i,j,n);
-
-			//continuar para a proxima casa
-			sqr = nextSquare(i,j);
-
-			//verificar se o puzzle se resolve com este numero nesta casa
-			if(solve(sqr.first,sqr.second))
-				return true;
-			//senao apagar o numero e tentar com outro
-			else {
-				unFillSqr(i,j,n);
+/**
+ * Casa vazia com menos candidatos (devolve false se nao houver casas vazias).
+ * Para logo numa casa com 0 ou 1 candidatos.
+ */
+bool Sudoku::bestSquare(int &bi, int &bj) const
+{
+	int best = 10;
+	for (int i = 0; i < 9; i++)
+		for (int j = 0; j < 9; j++) {
+			if (numbers[i][j] != 0)
 				continue;
+			int count = __builtin_popcount(candidates(i, j));
+			if (count < best) {
+				best = count;
+				bi = i;
+				bj = j;
+				if (count <= 1)
+					return true;
 			}
-
 		}
+	return best < 10;
+}
+
+bool Sudoku::solveNext() {
+
+	searchNodes++;
+	int mark = trailSize;
+	if (!propagate()) {
+		undo(mark);
+		return false;
 	}
+
+	int i, j;
+	if (isComplete() || !bestSquare(i, j))
+		return true;
+
+	//tentar cada candidato da casa com menos alternativas (bit menos significativo primeiro)
+	for (uint16_t cand = candidates(i, j); cand != 0; cand &= cand - 1) {
+		int n = __builtin_ctz(cand);
+		int branch = trailSize;
+		assign(i, j, n);
+		if (solveNext())
+			return true;
+		undo(branch);
+	}
+	undo(mark);
 	return false;
 }
 
 void Sudoku::fillSqr(int i, int j, int n) {
+	uint16_t bit = 1 << n;
 	numbers[i][j] = n;
-	block3x3HasNumber[i/3][j/3][n] = true;
-	columnHasNumber[j][n] = true;
-	lineHasNumber[i][n]=true;
+	lineMask[i] |= bit;
+	columnMask[j] |= bit;
+	blockMask[i / 3 * 3 + j / 3] |= bit;
 	countFilled++;
 }
 
-pair<int, int> Sudoku::nextSquare(int i, int j) {
-	if(i == 8) {
-		return make_pair(0,j+1);
-	}
-	else {
-		return make_pair(i+1,j);
-	}
+void Sudoku::unFillSqr(int i, int j, int n) {
+	uint16_t bit = 1 << n;
+	numbers[i][j] = 0;
+	lineMask[i] &= ~bit;
+	columnMask[j] &= ~bit;
+	blockMask[i / 3 * 3 + j / 3] &= ~bit;
+	countFilled--;
 }
 
 /**
@@ -172,11 +250,3 @@ void Sudoku::print()
 		cout << endl;
 	}
 }
-
-void Sudoku::unFillSqr(int i, int j, int n) {
-	numbers[i][j] =0;
-	block3x3HasNumber[i/3][j/3][n] = false;
-	columnHasNumber[j][n] = false;
-	lineHasNumber[i][n]=false;
-	countFilled--;
-}
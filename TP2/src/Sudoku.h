@@ -6,6 +6,7 @@
 #ifndef SUDOKU_H_
 #define SUDOKU_H_
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -25,12 +26,34 @@ class Sudoku
 	int numbers[9][9];
 
 	/**
-	 * Informao derivada da anterior, para acelerar processamento (nmero de 1 a 9, nao usa 0)
+	 * Informao derivada da anterior, para acelerar processamento: o bit n (de 1 a 9, nao usa 0)
+	 * indica que o nmero n j est na linha, coluna ou bloco 3x3 (bloco (i / 3) * 3 + j / 3).
+	 * Os candidatos de uma casa so os bits a 0 em lineMask[i] | columnMask[j] | blockMask[b].
 	 */
 	int countFilled;
-	bool columnHasNumber[9][10];
-	bool lineHasNumber[9][10];
-	bool block3x3HasNumber[3][3][10];
+	uint16_t lineMask[9];
+	uint16_t columnMask[9];
+	uint16_t blockMask[9];
+
+	static const uint16_t ALL_NUMBERS = 0x3FE;   // bits 1 a 9
+
+	uint16_t candidates(int i, int j) const {
+		return ~(lineMask[i] | columnMask[j] | blockMask[i / 3 * 3 + j / 3]) & ALL_NUMBERS;
+	}
+
+	/**
+	 * Casas preenchidas pela pesquisa (i * 9 + j), pela ordem em que o foram; para desfazer
+	 * basta apagar as casas ate uma marca anterior. Cada casa entra no maximo uma vez.
+	 */
+	uint8_t trail[81];
+	int trailSize;
+	long long searchNodes;
+
+	void assign(int i, int j, int n);
+	void undo(int mark);
+	bool propagate();
+	bool bestSquare(int &i, int &j) const;
+	bool solveNext();
 
 	void initialize();
 
@@ -64,16 +87,25 @@ public:
 	/**
 	 * Resolve o Sudoku.
 	 * Retorna indicao de sucesso ou insucesso (sudoku impossvel).
+	 *
+	 * Antes de cada ramificao propagam-se as jogadas foradas at no haver mais:
+	 * casas com um s candidato e nmeros que s cabem numa casa de uma linha, coluna
+	 * ou bloco. Ao voltar atrs, estas jogadas so desfeitas pelo registo (trail), sem
+	 * copiar o tabuleiro nem alocar memria.
 	 */
 	bool solve();
 
-    bool solve(int i,int j);
-
-    pair<int,int> nextSquare(int i,int j);
+	/**
+	 * Nmero de ns da pesquisa (chamadas recursivas) no ltimo solve().
+	 */
+	long long getSearchNodes() const { return searchNodes; }
 
-    void fillSqr(int i,int j,int n);
+	/**
+	 * Preenche (ou apaga) a casa (i, j) com o nmero n; cada uma  uma operao sobre bits.
+	 */
+	void fillSqr(int i, int j, int n);
 
-    void unFillSqr(int i,int j,int n);
+	void unFillSqr(int i, int j, int n);
 
 	/**
 	 * Imprime o Sudoku.
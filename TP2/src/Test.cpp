@@ -4,6 +4,13 @@
 #include "cute_runner.h"
 #include "Sudoku.h"
 #include "Labirinth.h"
+#include "MazeSolver.h"
+#include "WeightedLabirinth.h"
+#include "MazeComponents.h"
+#include "MazeDistances.h"
+#include "MazeFloodFill.h"
+#include "MazeGenerator.h"
+#include <queue>
 
 void compareSudokus(int in[9][9], int out[9][9])
 {
@@ -257,6 +264,74 @@ void testSudokuImpossible()
 }
 
 
+/* Solucao completa, valida e com as pistas iniciais. */
+void checkSudokuSolution(int in[9][9], int **out)
+{
+	for (int k = 0; k < 9; k++) {
+		int line = 0, column = 0, block = 0;
+		for (int m = 0; m < 9; m++) {
+			line |= 1 << out[k][m];
+			column |= 1 << out[m][k];
+			block |= 1 << out[k / 3 * 3 + m / 3][k % 3 * 3 + m % 3];
+		}
+		ASSERT_EQUAL(0x3FE, line);
+		ASSERT_EQUAL(0x3FE, column);
+		ASSERT_EQUAL(0x3FE, block);
+	}
+	for (int i = 0; i < 9; i++)
+		for (int j = 0; j < 9; j++)
+			if (in[i][j] != 0)
+				ASSERT_EQUAL(in[i][j], out[i][j]);
+}
+
+void testSudokuPropagation()
+{
+	// puzzles dificeis: com as jogadas forcadas bastam poucos nos de pesquisa
+	const char *puzzles[] = {
+		"800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+		"000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+		"400000805030000000000700000020000060000080400000010000000603070500200000104000000" };
+	for (const char *puzzle : puzzles) {
+		int in[9][9];
+		for (int k = 0; k < 81; k++)
+			in[k / 9][k % 9] = puzzle[k] - '0';
+		Sudoku s(in);
+		ASSERT_EQUAL(s.solve(), true);
+		ASSERT_EQUAL(s.isComplete(), true);
+		ASSERT(s.getSearchNodes() < 500);
+		checkSudokuSolution(in, s.getNumbers());
+	}
+
+	// so com singles (sem ramificar) resolve-se um puzzle facil num no
+	int easy[9][9] =
+		   {{5, 3, 0, 0, 7, 0, 0, 0, 0},
+			{6, 0, 0, 1, 9, 5, 0, 0, 0},
+			{0, 9, 8, 0, 0, 0, 0, 6, 0},
+			{8, 0, 0, 0, 6, 0, 0, 0, 3},
+			{4, 0, 0, 8, 0, 3, 0, 0, 1},
+			{7, 0, 0, 0, 2, 0, 0, 0, 6},
+			{0, 6, 0, 0, 0, 0, 2, 8, 0},
+			{0, 0, 0, 4, 1, 9, 0, 0, 5},
+			{0, 0, 0, 0, 8, 0, 0, 7, 9}};
+	Sudoku s(easy);
+	ASSERT_EQUAL(s.solve(), true);
+	ASSERT_EQUAL(1LL, s.getSearchNodes());
+	checkSudokuSolution(easy, s.getNumbers());
+
+	// resolver, apagar casas e resolver outra vez (o registo recomeca em cada solve)
+	int one[9][9] = {{0}};
+	one[0][0] = 5;
+	Sudoku again(one);
+	for (int round = 0; round < 3; round++) {
+		ASSERT_EQUAL(again.solve(), true);
+		int **out = again.getNumbers();
+		checkSudokuSolution(one, out);
+		for (int k = 1; k <= 40; k++)
+			again.unFillSqr(k / 9, k % 9, out[k / 9][k % 9]);
+		ASSERT_EQUAL(again.isComplete(), false);
+	}
+}
+
 void testLabirinth()
 {
 	int lab1[10][10] ={
@@ -293,6 +368,627 @@ void testLabirinth()
 }
 
 
+void testLabirinthGrid()
+{
+	int lab1[10][10] ={
+			{0,0,0,0,0,0,0,0,0,0},
+			{0,1,1,1,1,1,0,1,0,0},
+			{0,1,0,0,0,1,0,1,0,0},
+			{0,1,1,0,1,1,1,1,1,0},
+			{0,1,0,0,0,1,0,0,0,0},
+			{0,1,0,1,0,1,1,1,1,0},
+			{0,1,1,1,0,0,1,0,1,0},
+			{0,1,0,0,0,0,1,0,1,0},
+			{0,1,1,1,0,0,1,2,0,0},
+			{0,0,0,0,0,0,0,0,0,0}};
+	Labirinth l1(lab1);
+	ASSERT_EQUAL(10, l1.getWidth());
+	for (int y = 0; y < 10; y++)
+		for (int x = 0; x < 10; x++)
+			ASSERT_EQUAL(lab1[y][x], l1.getCell(x, y));
+	ASSERT_EQUAL(Labirinth::WALL, l1.getCell(-1, 3));
+	ASSERT_EQUAL(Labirinth::WALL, l1.getCell(3, 10));
+
+	Labirinth wide(100000, 3);
+	wide.setCell(99999, 2, Labirinth::GOAL);
+	wide.setCell(31, 1, Labirinth::FREE);
+	wide.setCell(32, 1, Labirinth::FREE);
+	wide.setCell(32, 1, Labirinth::WALL);
+	ASSERT_EQUAL(Labirinth::GOAL, wide.getCell(99999, 2));
+	ASSERT_EQUAL(Labirinth::FREE, wide.getCell(31, 1));
+	ASSERT_EQUAL(Labirinth::WALL, wide.getCell(32, 1));
+	ASSERT_EQUAL(3125u, wide.getRowWords());
+	ASSERT_THROWS(wide.setCell(100000, 0, 1), out_of_range);
+
+	// texto
+	const char *path = "testLabirinthGrid.txt";
+	FILE *f = fopen(path, "w");
+	fputs("0 0 0 0\r\n0 1 2 0\n\n0,1,1,0\n0000", f);
+	fclose(f);
+	Labirinth text = Labirinth::load(path);
+	ASSERT_EQUAL(4, text.getWidth());
+	ASSERT_EQUAL(4, text.getHeight());
+	ASSERT_EQUAL(Labirinth::GOAL, text.getCell(2, 1));
+	ASSERT_EQUAL(Labirinth::FREE, text.getCell(2, 2));
+	ASSERT_EQUAL(Labirinth::WALL, text.getCell(3, 2));
+
+	f = fopen(path, "w");
+	fputs("0 1\n0 1 1\n", f);
+	fclose(f);
+	ASSERT_THROWS(Labirinth::load(path), runtime_error);
+
+	// MovingAI
+	f = fopen(path, "w");
+	fputs("type octile\nheight 3\nwidth 5\nmap\n@@@@@\n@.GT@\n@@S.@\n", f);
+	fclose(f);
+	Labirinth movingAI = Labirinth::load(path);
+	ASSERT_EQUAL(5, movingAI.getWidth());
+	ASSERT_EQUAL(3, movingAI.getHeight());
+	ASSERT_EQUAL(Labirinth::FREE, movingAI.getCell(2, 1));
+	ASSERT_EQUAL(Labirinth::WALL, movingAI.getCell(3, 1));
+	ASSERT_EQUAL(Labirinth::FREE, movingAI.getCell(3, 2));
+
+	// binario: lido directamente do ficheiro mapeado; setCell passa a uma copia
+	wide.save(path);
+	Labirinth binary = Labirinth::load(path);
+	remove(path);
+	ASSERT_EQUAL(100000, binary.getWidth());
+	for (int y = 0; y < 3; y++)
+		for (int x = 0; x < 100000; x += 7)
+			ASSERT_EQUAL(wide.getCell(x, y), binary.getCell(x, y));
+	ASSERT_EQUAL(Labirinth::GOAL, binary.getCell(99999, 2));
+	Labirinth copy = binary;
+	binary.setCell(0, 0, Labirinth::GOAL);
+	ASSERT_EQUAL(Labirinth::GOAL, binary.getCell(0, 0));
+	ASSERT_EQUAL(Labirinth::WALL, copy.getCell(0, 0));
+	ASSERT_EQUAL(Labirinth::FREE, copy.getCell(31, 1));
+}
+
+/* Labirinto aleatorio com a fraccao de paredes indicada (em %), gerador fixo. */
+Labirinth randomLabirinth(int width, int height, int wallPercent, unsigned seed)
+{
+	Labirinth lab(width, height);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++) {
+			seed = seed * 1103515245 + 12345;
+			if ((int) ((seed >> 16) % 100) >= wallPercent)
+				lab.setCell(x, y, Labirinth::FREE);
+		}
+	return lab;
+}
+
+/* Distancia minima por uma BFS simples, para comparacao (-1 se inalcancavel). */
+int referenceDistance(const Labirinth &lab, int x, int y, int goalX, int goalY)
+{
+	int w = lab.getWidth();
+	vector<int> dist((size_t) w * lab.getHeight(), -1);
+	if (lab.getCell(x, y) == Labirinth::WALL)
+		return -1;
+	queue<pair<int,int> > q;
+	q.push(make_pair(x, y));
+	dist[y * w + x] = 0;
+	while (!q.empty()) {
+		pair<int,int> c = q.front();
+		q.pop();
+		if (c.first == goalX && c.second == goalY)
+			return dist[c.second * w + c.first];
+		for (int d = 0; d < 4; d++) {
+			int nx = c.first + DIRECTION_DX[d], ny = c.second + DIRECTION_DY[d];
+			if (lab.getCell(nx, ny) != Labirinth::WALL && dist[ny * w + nx] < 0) {
+				dist[ny * w + nx] = dist[c.second * w + c.first] + 1;
+				q.push(make_pair(nx, ny));
+			}
+		}
+	}
+	return -1;
+}
+
+/* O caminho so passa por celulas livres e termina em (goalX, goalY). */
+void checkPath(const Labirinth &lab, const MazePath &path, int goalX, int goalY)
+{
+	int x = path.getStartX(), y = path.getStartY();
+	for (size_t i = 0; i < path.size(); i++) {
+		x += DIRECTION_DX[path[i]];
+		y += DIRECTION_DY[path[i]];
+		ASSERT(lab.getCell(x, y) != Labirinth::WALL);
+	}
+	ASSERT_EQUAL(goalX, x);
+	ASSERT_EQUAL(goalY, y);
+}
+
+void testMazeSolver()
+{
+	// o objectivo so se alcanca subindo (y - 1)
+	int up[10][10] ={
+			{0,0,0,0,0,0,0,0,0,0},
+			{0,2,1,1,0,0,0,0,0,0},
+			{0,0,0,1,0,0,0,0,0,0},
+			{0,0,0,1,1,1,0,0,0,0},
+			{0,0,0,0,0,1,0,0,0,0},
+			{0,0,0,0,0,1,0,0,0,0},
+			{0,0,0,0,0,1,0,0,0,0},
+			{0,0,0,0,0,1,0,0,0,0},
+			{0,0,0,0,0,1,1,1,1,0},
+			{0,0,0,0,0,0,0,0,0,0}};
+	Labirinth l(up);
+	ASSERT(l.findGoal(8, 8));
+	MazeSolver solver(l);
+	MazePath path;
+	ASSERT(solver.findGoal(8, 8, path));
+	ASSERT_EQUAL("LLLUUUUULLUULL", path.toString());
+	ASSERT_EQUAL(make_pair(1, 1), path.getEnd());
+	ASSERT(solver.findPath(8, 8, 3, 2, path, MazeSolver::ASTAR));
+	ASSERT_EQUAL("LLLUUUUULLU", path.toString());
+	ASSERT(!solver.findGoal(0, 0, path));
+	ASSERT_EQUAL(0u, path.size());
+	ASSERT(solver.findGoal(1, 1, path));
+	ASSERT_EQUAL(0u, path.size());
+
+	// BFS e A* dao a mesma distancia que a referencia, com o mesmo MazeSolver
+	Labirinth lab = randomLabirinth(120, 90, 30, 42);
+	MazeSolver s(lab);
+	unsigned seed = 7;
+	for (int q = 0; q < 40; q++) {
+		int c[4];
+		for (int &v : c) {
+			seed = seed * 1103515245 + 12345;
+			v = (seed >> 16) % 90;
+		}
+		int expected = referenceDistance(lab, c[0], c[1], c[2], c[3]);
+		for (MazeSolver::Algorithm a : { MazeSolver::BFS, MazeSolver::ASTAR }) {
+			bool found = s.findPath(c[0], c[1], c[2], c[3], path, a);
+			ASSERT_EQUAL(expected >= 0, found);
+			if (found) {
+				ASSERT_EQUAL((size_t) expected, path.size());
+				checkPath(lab, path, c[2], c[3]);
+			}
+		}
+	}
+
+	// corredor em serpentina com 500000 celulas: a versao recursiva esgotava a pilha
+	int w = 1000, h = 999;
+	Labirinth snake(w, h);
+	for (int y = 0; y < h; y += 2) {
+		for (int x = 0; x < w; x++)
+			snake.setCell(x, y, Labirinth::FREE);
+		if (y + 1 < h)
+			snake.setCell((y / 2) % 2 == 0 ? w - 1 : 0, y + 1, Labirinth::FREE);
+	}
+	snake.setCell(w - 1, h - 1, Labirinth::GOAL);
+	ASSERT(snake.findGoal(0, 0));
+	MazeSolver snakeSolver(snake);
+	ASSERT(snakeSolver.findGoal(0, 0, path));
+	ASSERT_EQUAL((size_t) (499 * (w - 1) + 2 * 499), path.size());
+	checkPath(snake, path, w - 1, h - 1);
+	ASSERT(snakeSolver.findPath(0, 0, w - 1, h - 1, path, MazeSolver::ASTAR));
+	ASSERT_EQUAL((size_t) (499 * (w - 1) + 2 * 499), path.size());
+}
+
+void testMazeSolverAlgorithms()
+{
+	// os quatro algoritmos dao o mesmo comprimento, com varias densidades de paredes
+	MazePath path;
+	const MazeSolver::Algorithm algorithms[] = { MazeSolver::BFS, MazeSolver::ASTAR,
+			MazeSolver::JPS, MazeSolver::BIDIRECTIONAL };
+	for (int walls : { 0, 10, 25, 40 }) {
+		Labirinth lab = randomLabirinth(80, 60, walls, 100 + walls);
+		MazeSolver s(lab);
+		unsigned seed = walls + 1;
+		for (int q = 0; q < 60; q++) {
+			int c[4];
+			for (int &v : c) {
+				seed = seed * 1103515245 + 12345;
+				v = (seed >> 16) % 60;
+			}
+			int expected = referenceDistance(lab, c[0], c[1], c[2], c[3]);
+			for (MazeSolver::Algorithm a : algorithms) {
+				bool found = s.findPath(c[0], c[1], c[2], c[3], path, a);
+				ASSERT_EQUAL(expected >= 0, found);
+				if (found) {
+					ASSERT_EQUAL((size_t) expected, path.size());
+					checkPath(lab, path, c[2], c[3]);
+				}
+			}
+		}
+	}
+
+	// grelha aberta: o JPS e a pesquisa bidireccional expandem muito menos que a BFS
+	Labirinth open = randomLabirinth(400, 400, 0, 1);
+	open.setCell(200, 100, Labirinth::WALL);
+	MazeSolver s(open);
+	long long expanded[4];
+	for (int a = 0; a < 4; a++) {
+		ASSERT(s.findPath(10, 20, 390, 380, path, algorithms[a]));
+		ASSERT_EQUAL(740u, path.size());
+		checkPath(open, path, 390, 380);
+		expanded[a] = s.getExpanded();
+	}
+	ASSERT(expanded[0] > 100000);
+	ASSERT(expanded[2] < 100);
+	ASSERT(expanded[3] < expanded[0]);
+	ASSERT(s.findPath(5, 5, 5, 5, path, MazeSolver::JPS));
+	ASSERT_EQUAL(0u, path.size());
+
+	// o JPS guarda dados por linha durante a pesquisa; mudar o labirinto entre pesquisas
+	// nao pode deixar respostas antigas
+	for (int x = 0; x < 399; x++)
+		open.setCell(x, 300, Labirinth::WALL);
+	for (int k = 0; k < 3; k++) {
+		ASSERT(s.findPath(10, 20, 10, 390, path, MazeSolver::JPS));
+		ASSERT_EQUAL((size_t) referenceDistance(open, 10, 20, 10, 390), path.size());
+		checkPath(open, path, 10, 390);
+		open.setCell(399 - 100 * k, 300, Labirinth::WALL);
+		open.setCell(299 - 100 * k, 300, Labirinth::FREE);
+	}
+}
+
+void testMazeComponents()
+{
+	int lab1[10][10] ={
+			{0,0,0,0,0,0,0,0,0,0},
+			{0,1,1,1,1,1,0,1,0,0},
+			{0,1,0,0,0,1,0,1,0,0},
+			{0,1,1,0,1,1,1,1,1,0},
+			{0,1,0,0,0,1,0,0,0,0},
+			{0,1,0,1,0,1,1,1,1,0},
+			{0,1,1,1,0,0,1,0,1,0},
+			{0,1,0,0,0,0,1,0,1,0},
+			{0,1,1,1,0,0,0,2,0,0},
+			{0,0,0,0,0,0,0,0,0,0}};
+	Labirinth l1(lab1);
+	MazeComponents c1(l1);
+	ASSERT_EQUAL(2u, c1.getCount());
+	ASSERT_EQUAL(0u, c1.getLabel(0, 0));
+	ASSERT_EQUAL(1u, c1.getLabel(1, 1));
+	ASSERT(c1.connected(1, 1, 8, 7));
+	ASSERT(!c1.connected(1, 1, 7, 8));
+	ASSERT(!c1.canReachGoal(1, 1));
+	ASSERT(c1.canReachGoal(7, 8));
+	ASSERT(!c1.canReachGoal(0, 0));
+	ASSERT(!c1.canReachGoal(-3, 20));
+
+	// comparar com as pesquisas, em labirintos com linhas de mais de 64 celulas
+	for (int walls : { 20, 40, 55 }) {
+		Labirinth lab = randomLabirinth(150, 70, walls, walls);
+		lab.setCell(149, 69, Labirinth::GOAL);
+		lab.setCell(64, 10, Labirinth::GOAL);
+		MazeComponents c(lab);
+		MazeSolver solver(lab);
+		MazePath path;
+		vector<pair<int,int> > starts;
+		unsigned seed = walls;
+		for (int q = 0; q < 300; q++) {
+			int p[4];
+			for (int &v : p) {
+				seed = seed * 1103515245 + 12345;
+				v = (seed >> 16) % 70;
+			}
+			p[0] *= 2;
+			ASSERT_EQUAL(referenceDistance(lab, p[0], p[1], p[2], p[3]) >= 0, c.connected(p[0], p[1], p[2], p[3]));
+			starts.push_back(make_pair(p[0], p[1]));
+		}
+		vector<bool> reach = c.canReachGoal(starts);
+		for (size_t i = 0; i < starts.size(); i++)
+			ASSERT_EQUAL(solver.findGoal(starts[i].first, starts[i].second, path), (bool) reach[i]);
+	}
+
+	// em faixas paralelas os numeros sao exactamente os de uma so thread
+	Labirinth big = randomLabirinth(300, 700, 38, 5);
+	for (int x = 0; x < 300; x++)
+		big.setCell(x, 350, Labirinth::WALL);
+	for (int y = 0; y < 700; y++)
+		big.setCell(150, y, Labirinth::FREE);
+	big.setCell(299, 699, Labirinth::GOAL);
+	MazeComponents serial(big, 1);
+	for (unsigned threads : { 2u, 4u, 7u, 16u }) {
+		MazeComponents parallel(big, threads);
+		ASSERT_EQUAL(serial.getCount(), parallel.getCount());
+		for (int y = 0; y < 700; y++)
+			for (int x = 0; x < 300; x++) {
+				ASSERT_EQUAL(serial.getLabel(x, y), parallel.getLabel(x, y));
+				ASSERT_EQUAL(serial.canReachGoal(x, y), parallel.canReachGoal(x, y));
+			}
+	}
+	ASSERT(serial.connected(150, 0, 150, 699));
+}
+
+void testMazeFloodFill()
+{
+	// o conjunto alcancado e a componente da partida, com linhas de varias palavras
+	for (int walls : { 0, 30, 45, 60 }) {
+		Labirinth lab = randomLabirinth(333, 120, walls, 9 + walls);
+		lab.setCell(300, 100, Labirinth::GOAL);
+		MazeComponents components(lab, 1);
+		MazeFloodFill flood(lab);
+		unsigned seed = walls + 3;
+		for (int q = 0; q < 20; q++) {
+			seed = seed * 1103515245 + 12345;
+			int x = (seed >> 16) % 333;
+			seed = seed * 1103515245 + 12345;
+			int y = (seed >> 16) % 120;
+			uint32_t label = components.getLabel(x, y);
+			ASSERT_EQUAL(label != 0, flood.fill(x, y));
+			size_t count = 0;
+			for (int cy = 0; cy < 120; cy++)
+				for (int cx = 0; cx < 333; cx++) {
+					bool same = label != 0 && components.getLabel(cx, cy) == label;
+					ASSERT_EQUAL(same, flood.isReached(cx, cy));
+					count += same;
+				}
+			ASSERT_EQUAL(count, flood.getReachedCount());
+			ASSERT_EQUAL(components.canReachGoal(x, y), flood.findGoal(x, y));
+		}
+	}
+
+	// serpentina: muitas voltas para cima e para baixo
+	int w = 200, h = 199;
+	Labirinth snake(w, h);
+	for (int x = 0; x < w; x += 2) {
+		for (int y = 0; y < h; y++)
+			snake.setCell(x, y, Labirinth::FREE);
+		if (x + 1 < w)
+			snake.setCell(x + 1, (x / 2) % 2 == 0 ? h - 1 : 0, Labirinth::FREE);
+	}
+	snake.setCell(w - 2, 0, Labirinth::GOAL);
+	MazeFloodFill flood(snake);
+	ASSERT(flood.fill(0, 0));
+	ASSERT_EQUAL((size_t) (100 * h + 100), flood.getReachedCount());
+	ASSERT(flood.findGoal(0, 0));
+	ASSERT(!flood.fill(1, 5));
+	ASSERT_EQUAL(0u, flood.getReachedCount());
+}
+
+/* Compara todas as distancias de um campo com uma BFS completa a partir do objectivo. */
+void checkDistanceField(const Labirinth &lab, const DistanceField &field, int goalX, int goalY)
+{
+	int w = lab.getWidth(), h = lab.getHeight();
+	vector<int> dist((size_t) w * h, -1);
+	queue<pair<int,int> > q;
+	if (lab.getCell(goalX, goalY) == Labirinth::GOAL) {
+		dist[goalY * w + goalX] = 0;
+		q.push(make_pair(goalX, goalY));
+	}
+	while (!q.empty()) {
+		pair<int,int> c = q.front();
+		q.pop();
+		for (int d = 0; d < 4; d++) {
+			int nx = c.first + DIRECTION_DX[d], ny = c.second + DIRECTION_DY[d];
+			if (lab.getCell(nx, ny) != Labirinth::WALL && dist[ny * w + nx] < 0) {
+				dist[ny * w + nx] = dist[c.second * w + c.first] + 1;
+				q.push(make_pair(nx, ny));
+			}
+		}
+	}
+	for (int y = 0; y < h; y++)
+		for (int x = 0; x < w; x++) {
+			int d = dist[y * w + x];
+			ASSERT_EQUAL(d < 0 ? DistanceField::UNREACHABLE : (uint32_t) d, field.getDistance(x, y));
+		}
+}
+
+void testMazeDistances()
+{
+	int w = 60, h = 45;
+	Labirinth lab = randomLabirinth(w, h, 30, 21);
+	lab.setCell(5, 5, Labirinth::GOAL);
+	lab.setCell(50, 40, Labirinth::GOAL);
+	MazeDistances distances(lab);
+	const DistanceField &first = distances.toGoal(5, 5);
+	const DistanceField &second = distances.toGoal(50, 40);
+	const DistanceField &nearest = distances.toNearestGoal();
+	ASSERT_EQUAL(&first, &distances.toGoal(5, 5));
+	ASSERT_EQUAL(3u, distances.getFieldCount());
+	ASSERT_THROWS(distances.toGoal(6, 5), invalid_argument);
+
+	// paredes que abrem e fecham (incluindo os objectivos): os campos continuam exactos
+	MazeSolver solver(lab);
+	MazePath path;
+	unsigned seed = 77;
+	for (int step = 0; step < 300; step++) {
+		seed = seed * 1103515245 + 12345;
+		int x = (seed >> 16) % w;
+		seed = seed * 1103515245 + 12345;
+		int y = (seed >> 16) % h;
+		int value = lab.getCell(x, y) == Labirinth::WALL ? Labirinth::FREE : Labirinth::WALL;
+		if ((x == 5 && y == 5) || (x == 50 && y == 40))
+			value = lab.getCell(x, y) == Labirinth::GOAL ? Labirinth::FREE : Labirinth::GOAL;
+		distances.setCell(x, y, value);
+		if (step % 10 == 0) {
+			checkDistanceField(lab, first, 5, 5);
+			checkDistanceField(lab, second, 50, 40);
+			for (int sy = 0; sy < h; sy += 7)
+				for (int sx = 0; sx < w; sx += 5) {
+					uint32_t d = nearest.getDistance(sx, sy);
+					ASSERT_EQUAL(d, min(first.getDistance(sx, sy), second.getDistance(sx, sy)));
+					ASSERT_EQUAL(d != DistanceField::UNREACHABLE, nearest.getPath(sx, sy, path));
+					if (d != DistanceField::UNREACHABLE) {
+						ASSERT_EQUAL((size_t) d, path.size());
+						pair<int,int> end = path.getEnd();
+						checkPath(lab, path, end.first, end.second);
+						ASSERT_EQUAL(Labirinth::GOAL, lab.getCell(end.first, end.second));
+						ASSERT(solver.findGoal(sx, sy, path));
+						ASSERT_EQUAL((size_t) d, path.size());
+					}
+				}
+		}
+	}
+
+	// numa sala aberta grande, abrir ou fechar uma parede longe do objectivo mexe em poucas celulas
+	Labirinth open(300, 300);
+	for (int y = 0; y < 300; y++)
+		for (int x = 0; x < 300; x++)
+			open.setCell(x, y, Labirinth::FREE);
+	open.setCell(0, 0, Labirinth::GOAL);
+	MazeDistances openDistances(open);
+	const DistanceField &field = openDistances.toNearestGoal();
+	ASSERT_EQUAL(90000LL, field.getUpdated());
+	openDistances.setCell(250, 250, Labirinth::WALL);
+	ASSERT(field.getUpdated() < 10);
+	ASSERT_EQUAL(DistanceField::UNREACHABLE, field.getDistance(250, 250));
+	ASSERT_EQUAL(502u, field.getDistance(251, 251));
+	openDistances.setCell(250, 250, Labirinth::FREE);
+	ASSERT(field.getUpdated() < 10);
+	ASSERT_EQUAL(500u, field.getDistance(250, 250));
+	checkDistanceField(open, field, 0, 0);
+}
+
+/* Dijkstra simples com heap, para comparacao (-1 se inalcancavel). */
+long long referenceCost(const WeightedLabirinth &lab, int x, int y, int goalX, int goalY)
+{
+	int w = lab.getWidth();
+	vector<long long> dist((size_t) w * lab.getHeight(), -1);
+	priority_queue<pair<long long,int>, vector<pair<long long,int> >, greater<pair<long long,int> > > q;
+	if (lab.getCost(x, y) == WeightedLabirinth::WALL)
+		return -1;
+	dist[y * w + x] = 0;
+	q.push(make_pair(0LL, y * w + x));
+	while (!q.empty()) {
+		pair<long long,int> top = q.top();
+		q.pop();
+		int cx = top.second % w, cy = top.second / w;
+		if (top.first != dist[top.second])
+			continue;
+		if (cx == goalX && cy == goalY)
+			return top.first;
+		for (int d = 0; d < 4; d++) {
+			int nx = cx + DIRECTION_DX[d], ny = cy + DIRECTION_DY[d];
+			int cost = lab.getCost(nx, ny);
+			long long &nd = dist[ny * w + nx];
+			if (cost != WeightedLabirinth::WALL && (nd < 0 || nd > top.first + cost)) {
+				nd = top.first + cost;
+				q.push(make_pair(nd, ny * w + nx));
+			}
+		}
+	}
+	return -1;
+}
+
+void testWeightedLabirinth()
+{
+	// com custo 1 em todas as celulas livres da o mesmo que a BFS
+	Labirinth plain = randomLabirinth(90, 70, 35, 4);
+	WeightedLabirinth uniform(plain);
+	WeightedMazeSolver uniformSolver(uniform);
+	MazePath path;
+	for (int i = 0; i < 30; i++) {
+		int x = (i * 37) % 90, y = (i * 23) % 70, gx = (i * 53 + 11) % 90, gy = (i * 41 + 7) % 70;
+		int expected = referenceDistance(plain, x, y, gx, gy);
+		uint64_t cost = uniformSolver.findPath(x, y, gx, gy, path);
+		ASSERT_EQUAL(expected < 0, cost == WeightedMazeSolver::UNREACHABLE);
+		if (expected >= 0) {
+			ASSERT_EQUAL((uint64_t) expected, cost);
+			checkPath(plain, path, gx, gy);
+		} else
+			ASSERT_EQUAL(0u, path.size());
+	}
+
+	// custos de 1 a 9 (0 = parede): custo minimo e custo do caminho devolvido
+	WeightedLabirinth lab(120, 80);
+	unsigned seed = 5;
+	for (int y = 0; y < 80; y++)
+		for (int x = 0; x < 120; x++) {
+			seed = seed * 1103515245 + 12345;
+			lab.setCost(x, y, (seed >> 16) % 10);
+		}
+	ASSERT_EQUAL(9, lab.getMaxCost());
+	WeightedMazeSolver solver(lab);
+	for (int i = 0; i < 40; i++) {
+		int x = (i * 31) % 120, y = (i * 17) % 80, gx = (i * 67 + 5) % 120, gy = (i * 29 + 3) % 80;
+		long long expected = referenceCost(lab, x, y, gx, gy);
+		uint64_t cost = solver.findPath(x, y, gx, gy, path);
+		if (expected < 0) {
+			ASSERT_EQUAL(WeightedMazeSolver::UNREACHABLE, cost);
+			continue;
+		}
+		ASSERT_EQUAL((uint64_t) expected, cost);
+		int cx = x, cy = y;
+		uint64_t sum = 0;
+		for (size_t k = 0; k < path.size(); k++) {
+			cx += DIRECTION_DX[path[k]];
+			cy += DIRECTION_DY[path[k]];
+			ASSERT(lab.getCost(cx, cy) != WeightedLabirinth::WALL);
+			sum += lab.getCost(cx, cy);
+		}
+		ASSERT_EQUAL(gx, cx);
+		ASSERT_EQUAL(gy, cy);
+		ASSERT_EQUAL(cost, sum);
+	}
+
+	// um desvio barato ganha ao caminho directo caro
+	WeightedLabirinth detour(5, 3);
+	for (int x = 0; x < 5; x++) {
+		detour.setCost(x, 0, 1);
+		detour.setCost(x, 1, x == 0 || x == 4 ? 1 : 200);
+	}
+	WeightedMazeSolver detourSolver(detour);
+	ASSERT_EQUAL(6u, detourSolver.findPath(0, 1, 4, 1, path));
+	ASSERT_EQUAL(string("URRRRD"), path.toString());
+	ASSERT_THROWS(detour.setCost(0, 0, 256), invalid_argument);
+	ASSERT_THROWS(detour.setCost(5, 0, 1), out_of_range);
+}
+
+/* Numero de celulas livres e de pares de celulas livres vizinhas. */
+pair<long long, long long> countCellsAndEdges(const Labirinth &lab)
+{
+	long long cells = 0, edges = 0;
+	for (int y = 0; y < lab.getHeight(); y++)
+		for (int x = 0; x < lab.getWidth(); x++)
+			if (lab.getCell(x, y) != Labirinth::WALL) {
+				cells++;
+				edges += lab.getCell(x + 1, y) != Labirinth::WALL;
+				edges += lab.getCell(x, y + 1) != Labirinth::WALL;
+			}
+	return make_pair(cells, edges);
+}
+
+bool sameCells(const Labirinth &a, const Labirinth &b)
+{
+	for (int y = 0; y < a.getHeight(); y++)
+		for (int x = 0; x < a.getWidth(); x++)
+			if (a.getCell(x, y) != b.getCell(x, y))
+				return false;
+	return true;
+}
+
+void testMazeGenerator()
+{
+	// labirintos perfeitos: tudo ligado e sem ciclos (arestas = celulas - 1)
+	for (int size : { 1, 2, 15, 64, 101 }) {
+		Labirinth perfect[2] = { MazeGenerator::kruskal(size, size + 6, size), MazeGenerator::wilson(size, size + 6, size) };
+		for (const Labirinth &lab : perfect) {
+			ASSERT_EQUAL(size, lab.getWidth());
+			ASSERT_EQUAL(size + 6, lab.getHeight());
+			pair<long long, long long> counts = countCellsAndEdges(lab);
+			ASSERT_EQUAL(counts.first - 1, counts.second);
+			ASSERT_EQUAL(1u, MazeComponents(lab, 1).getCount());
+			ASSERT_EQUAL(Labirinth::FREE, lab.getCell(0, 0));
+		}
+	}
+
+	// a mesma semente da o mesmo labirinto, outra semente outro
+	ASSERT(sameCells(MazeGenerator::kruskal(81, 61, 7), MazeGenerator::kruskal(81, 61, 7)));
+	ASSERT(!sameCells(MazeGenerator::kruskal(81, 61, 7), MazeGenerator::kruskal(81, 61, 8)));
+	ASSERT(sameCells(MazeGenerator::wilson(81, 61, 7), MazeGenerator::wilson(81, 61, 7)));
+	ASSERT(sameCells(MazeGenerator::caves(81, 61, 7), MazeGenerator::caves(81, 61, 7)));
+	ASSERT(!sameCells(MazeGenerator::rooms(81, 61, 7), MazeGenerator::rooms(81, 61, 8)));
+
+	// grutas: as iteracoes alisam, ficam paredes e espacos abertos
+	Labirinth caves = MazeGenerator::caves(200, 150, 3);
+	long long freeCells = countCellsAndEdges(caves).first;
+	ASSERT(freeCells > 200 * 150 / 4 && freeCells < 200 * 150 * 3 / 4);
+	Labirinth empty = MazeGenerator::caves(50, 50, 3, 0, 0);
+	ASSERT_EQUAL(2500LL, countCellsAndEdges(empty).first);
+
+	// salas: tudo ligado, e a maior parte das celulas livres
+	for (int roomSize : { 3, 8, 16 }) {
+		Labirinth rooms = MazeGenerator::rooms(130, 97, 11, roomSize);
+		ASSERT_EQUAL(1u, MazeComponents(rooms, 1).getCount());
+		ASSERT(countCellsAndEdges(rooms).first > 130 * 97 / 2);
+	}
+	ASSERT_THROWS(MazeGenerator::kruskal(0, 5, 1), invalid_argument);
+	ASSERT_THROWS(MazeGenerator::rooms(10, 10, 1, 2), invalid_argument);
+}
+
 
 bool runAllTests(int argc, char const *argv[]) {
 	cute::suite s { };
@@ -304,7 +1000,16 @@ bool runAllTests(int argc, char const *argv[]) {
 	s.push_back(CUTE(testSudokuWithMultipleSolutions));
 	s.push_back(CUTE(testSudokuEmpty));
 	s.push_back(CUTE(testSudokuImpossible));
+	s.push_back(CUTE(testSudokuPropagation));
 	s.push_back(CUTE(testLabirinth));
+	s.push_back(CUTE(testLabirinthGrid));
+	s.push_back(CUTE(testMazeSolver));
+	s.push_back(CUTE(testMazeSolverAlgorithms));
+	s.push_back(CUTE(testMazeComponents));
+	s.push_back(CUTE(testMazeFloodFill));
+	s.push_back(CUTE(testMazeDistances));
+	s.push_back(CUTE(testWeightedLabirinth));
+	s.push_back(CUTE(testMazeGenerator));
 	cute::xml_file_opener xmlfile(argc, argv);
 	cute::xml_listener<cute::ide_listener<>> lis(xmlfile.out);
 	auto runner = cute::makeRunner(lis, argc, argv);
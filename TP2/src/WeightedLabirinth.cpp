@@ -0,0 +1,122 @@
+/*
+ * WeightedLabirinth.cpp
+ *
+ */
+
+#include "WeightedLabirinth.h"
+
+#include <stdexcept>
+
+const int WeightedLabirinth::WALL;
+const int WeightedLabirinth::MAX_COST;
+const uint64_t WeightedMazeSolver::UNREACHABLE;
+
+WeightedLabirinth::WeightedLabirinth(int width, int height)
+	: width(width), height(height), maxCost(1)
+{
+	if (width < 0 || height < 0)
+		throw invalid_argument("WeightedLabirinth: negative size");
+	costs.assign((size_t) width * height, WALL);
+}
+
+WeightedLabirinth::WeightedLabirinth(const Labirinth &lab, int cost)
+	: WeightedLabirinth(lab.getWidth(), lab.getHeight())
+{
+	if (cost < 1 || cost > MAX_COST)
+		throw invalid_argument("WeightedLabirinth: cost must be between 1 and 255");
+	maxCost = cost;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (lab.getCell(x, y) != Labirinth::WALL)
+				costs[(size_t) y * width + x] = cost;
+}
+
+void WeightedLabirinth::setCost(int x, int y, int cost)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		throw out_of_range("WeightedLabirinth: cell outside the maze");
+	if (cost < WALL || cost > MAX_COST)
+		throw invalid_argument("WeightedLabirinth: cost must be between 0 and 255");
+	costs[(size_t) y * width + x] = cost;
+	if (cost > maxCost)
+		maxCost = cost;
+}
+
+WeightedMazeSolver::WeightedMazeSolver(const WeightedLabirinth &lab)
+	: lab(lab), width(lab.getWidth()), height(lab.getHeight()), expanded(0)
+{
+	size_t cells = (size_t) width * height;
+	if (cells >= UINT32_MAX)
+		throw invalid_argument("WeightedMazeSolver: maze too large (2^32 cells or more)");
+	dist.assign(cells, UNREACHABLE);
+	parent.assign(cells, 0);
+}
+
+void WeightedMazeSolver::reset()
+{
+	for (uint32_t cell : touched)
+		dist[cell] = UNREACHABLE;
+	touched.clear();
+	for (vector<uint32_t> &bucket : buckets)
+		bucket.clear();
+	expanded = 0;
+}
+
+uint64_t WeightedMazeSolver::findPath(int x, int y, int goalX, int goalY, MazePath &path)
+{
+	reset();
+	path.clear(x, y);
+	if (lab.getCost(x, y) == WeightedLabirinth::WALL || lab.getCost(goalX, goalY) == WeightedLabirinth::WALL)
+		return UNREACHABLE;
+
+	// as distancias pendentes estao em [d, d + maxCost]: maxCost + 1 baldes chegam
+	size_t numBuckets = lab.getMaxCost() + 1;
+	if (buckets.size() < numBuckets)
+		buckets.resize(numBuckets);
+	uint32_t start = (uint32_t) y * width + x, goal = (uint32_t) goalY * width + goalX;
+	dist[start] = 0;
+	touched.push_back(start);
+	buckets[0].push_back(start);
+	size_t pending = 1;
+
+	for (uint64_t d = 0; pending > 0; d++) {
+		vector<uint32_t> &bucket = buckets[d % numBuckets];
+		// os custos sao >= 1, por isso nada e acrescentado ao balde actual durante o ciclo
+		for (size_t i = 0; i < bucket.size(); i++) {
+			uint32_t cell = bucket[i];
+			pending--;
+			if (dist[cell] != d)
+				continue;
+			expanded++;
+			if (cell == goal) {
+				reversed.clear();
+				while (cell != start) {
+					int dir = parent[cell];
+					reversed.push_back(dir);
+					int px = cell % width - DIRECTION_DX[dir], py = cell / width - DIRECTION_DY[dir];
+					cell = (uint32_t) py * width + px;
+				}
+				for (size_t k = reversed.size(); k > 0; k--)
+					path.push_back((Direction) reversed[k - 1]);
+				return d;
+			}
+			int cx = cell % width, cy = cell / width;
+			for (int dir = 0; dir < 4; dir++) {
+				int cost = lab.getCost(cx + DIRECTION_DX[dir], cy + DIRECTION_DY[dir]);
+				if (cost == WeightedLabirinth::WALL)
+					continue;
+				uint32_t next = cell + DIRECTION_DX[dir] + DIRECTION_DY[dir] * width;
+				if (dist[next] == UNREACHABLE)
+					touched.push_back(next);
+				else if (dist[next] <= d + cost)
+					continue;
+				dist[next] = d + cost;
+				parent[next] = dir;
+				buckets[(d + cost) % numBuckets].push_back(next);
+				pending++;
+			}
+		}
+		bucket.clear();
+	}
+	return UNREACHABLE;
+}
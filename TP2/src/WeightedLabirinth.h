@@ -0,0 +1,98 @@
+/*
+ * WeightedLabirinth.h
+ *
+ */
+
+#ifndef WEIGHTEDLABIRINTH_H_
+#define WEIGHTEDLABIRINTH_H_
+
+#include "Labirinth.h"
+#include "MazeSolver.h"
+
+/**
+ * Labirinto em que cada celula tem um custo de travessia, de 1 a MAX_COST (0 = parede).
+ * Entrar numa celula custa o seu custo; um byte por celula, linha a linha.
+ */
+class WeightedLabirinth {
+	int width, height;
+	vector<uint8_t> costs;      // costs[y * width + x]
+	int maxCost;                // maior custo usado ate agora (limite superior)
+
+public:
+	static const int WALL = 0;
+	static const int MAX_COST = 255;
+
+	/**
+	 * Labirinto width x height so com paredes.
+	 */
+	WeightedLabirinth(int width, int height);
+
+	/**
+	 * Labirinto com as paredes de lab e custo cost em todas as outras celulas.
+	 */
+	WeightedLabirinth(const Labirinth &lab, int cost = 1);
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+	/**
+	 * Custo da celula (x, y); as celulas fora do labirinto sao paredes.
+	 */
+	int getCost(int x, int y) const {
+		if (x < 0 || y < 0 || x >= width || y >= height)
+			return WALL;
+		return costs[(size_t) y * width + x];
+	}
+
+	/**
+	 * Altera o custo de uma celula (0 = parede).
+	 * Lanca out_of_range fora do labirinto e invalid_argument se o custo nao estiver entre 0 e MAX_COST.
+	 */
+	void setCost(int x, int y, int cost);
+
+	int getMaxCost() const { return maxCost; }
+};
+
+/**
+ * Caminhos de custo minimo num WeightedLabirinth (Dijkstra com fila de Dial).
+ *
+ * Como os custos sao inteiros pequenos, a fila de prioridade e um anel de getMaxCost() + 1
+ * baldes indexados pela distancia: as distancias pendentes estao sempre entre d e d + maxCost,
+ * por isso cada insercao e remocao e O(1), sem heap. Os vizinhos sao calculados a partir da
+ * grelha, sem listas de adjacencia. Tal como no MazeSolver, o estado e alocado uma vez e, no
+ * inicio de cada pesquisa, so se limpam as celulas tocadas pela anterior.
+ */
+class WeightedMazeSolver {
+	const WeightedLabirinth &lab;
+	int width, height;
+	vector<uint64_t> dist;              // distancia desde a partida (UNREACHABLE = nao tocada)
+	vector<uint8_t> parent;             // direccao de chegada
+	vector<uint32_t> touched;
+	vector<vector<uint32_t> > buckets;
+	vector<uint8_t> reversed;
+	long long expanded;
+
+	void reset();
+
+public:
+	static const uint64_t UNREACHABLE = UINT64_MAX;
+
+	/**
+	 * O labirinto nao deve mudar de dimensoes enquanto o solver existir.
+	 */
+	WeightedMazeSolver(const WeightedLabirinth &lab);
+
+	/**
+	 * Caminho de custo minimo de (x, y) ate (goalX, goalY).
+	 * Devolve o custo (soma dos custos das celulas em que se entra), ou UNREACHABLE
+	 * (e um caminho vazio) se o destino nao for alcancavel.
+	 */
+	uint64_t findPath(int x, int y, int goalX, int goalY, MazePath &path);
+
+	/**
+	 * Celulas expandidas (retiradas dos baldes) na ultima pesquisa.
+	 */
+	long long getExpanded() const { return expanded; }
+};
+
+#endif /* WEIGHTEDLABIRINTH_H_ */